@@ -0,0 +1,111 @@
+#include "bakedtrack.h"
+#include <fstream>
+#include <cstdint>
+
+#define BAKED_TRACK_MAGIC 0x54424344 //"DCBT"
+#define BAKED_TRACK_VERSION 1
+
+struct BakedTrackHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	int32_t startFrame;
+	uint32_t frameCount;
+};
+
+BakedTrack::BakedTrack()
+{
+}
+
+BakedTrack::BakedTrack(int _startFrame) : startFrame(_startFrame)
+{
+}
+
+void BakedTrack::AddFrame(NewPOV pov)
+{
+	frames.push_back(pov);
+}
+
+int BakedTrack::GetStartFrame() const
+{
+	return startFrame;
+}
+
+int BakedTrack::GetEndFrame() const
+{
+	return startFrame + (int)frames.size() - 1;
+}
+
+size_t BakedTrack::GetFrameCount() const
+{
+	return frames.size();
+}
+
+bool BakedTrack::GetFrame(int frame, NewPOV& pov) const
+{
+	if (frame < startFrame || frame > GetEndFrame())
+		return false;
+	pov = frames[frame - startFrame];
+	return pov.FOV >= 1;
+}
+
+bool BakedTrack::SaveToFile(std::string filename) const
+{
+	std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	BakedTrackHeader header = { BAKED_TRACK_MAGIC, BAKED_TRACK_VERSION, startFrame, (uint32_t)frames.size() };
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	std::vector<float> data;
+	data.reserve(frames.size() * 7);
+	for (const auto& pov : frames)
+	{
+		data.push_back(pov.location.X);
+		data.push_back(pov.location.Y);
+		data.push_back(pov.location.Z);
+		data.push_back(pov.rotation.Pitch._value);
+		data.push_back(pov.rotation.Yaw._value);
+		data.push_back(pov.rotation.Roll._value);
+		data.push_back(pov.FOV);
+	}
+	file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+	return file.good();
+}
+
+bool BakedTrack::LoadFromFile(std::string filename)
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	BakedTrackHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != BAKED_TRACK_MAGIC || header.version != BAKED_TRACK_VERSION)
+		return false;
+
+	//The frame count comes from the file, check the file holds that many frames before allocating for them
+	std::streamoff dataStart = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff dataSize = file.tellg() - dataStart;
+	file.seekg(dataStart);
+	if ((uint64_t)header.frameCount * 7 * sizeof(float) != (uint64_t)dataSize)
+		return false;
+
+	std::vector<float> data((size_t)header.frameCount * 7);
+	if (!file.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float)))
+		return false;
+
+	startFrame = header.startFrame;
+	frames.clear();
+	frames.reserve(header.frameCount);
+	for (size_t i = 0; i < data.size(); i += 7)
+	{
+		NewPOV pov;
+		pov.location = Vector(data[i], data[i + 1], data[i + 2]);
+		pov.rotation = CustomRotator(data[i + 3], data[i + 4], data[i + 5]);
+		pov.FOV = data[i + 6];
+		frames.push_back(pov);
+	}
+	return true;
+}
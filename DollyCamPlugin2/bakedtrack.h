@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "models.h"
+
+//Camera state for every replay frame of a path, precomputed so playback is a single lookup
+class BakedTrack
+{
+private:
+	int startFrame = 0;
+	std::vector<NewPOV> frames;
+
+public:
+	BakedTrack();
+	BakedTrack(int startFrame);
+	void AddFrame(NewPOV pov);
+	int GetStartFrame() const;
+	int GetEndFrame() const;
+	size_t GetFrameCount() const;
+	//Returns false if the frame is outside the track or the baked camera state is invalid
+	bool GetFrame(int frame, NewPOV& pov) const;
+
+	//Compact binary format: header followed by 7 floats (location, rotation, FOV) per frame
+	bool SaveToFile(std::string filename) const;
+	bool LoadFromFile(std::string filename);
+};
@@ -0,0 +1,44 @@
+#include "bandedsolver.h"
+#include <cmath>
+#include <algorithm>
+
+void SolveBanded(std::vector<double>& band, std::vector<double>& b, size_t n, size_t bandwidth, size_t channels)
+{
+	auto L = [&](size_t i, size_t k) -> double& { return band[i * (bandwidth + 1) + (i - k)]; };
+	for (size_t j = 0; j < n; j++)
+	{
+		size_t first = j > bandwidth ? j - bandwidth : 0;
+		double diagonal = L(j, j);
+		for (size_t k = first; k < j; k++)
+			diagonal -= L(j, k) * L(j, k);
+		diagonal = sqrt((std::max)(diagonal, 1e-12));
+		L(j, j) = diagonal;
+
+		for (size_t i = j + 1; i < n && i <= j + bandwidth; i++)
+		{
+			size_t firstI = i > bandwidth ? i - bandwidth : 0;
+			double sum = L(i, j);
+			for (size_t k = (std::max)(first, firstI); k < j; k++)
+				sum -= L(i, k) * L(j, k);
+			L(i, j) = sum / diagonal;
+		}
+	}
+
+	for (size_t c = 0; c < channels; c++)
+	{
+		for (size_t i = 0; i < n; i++) //L*y = b
+		{
+			double sum = b[i * channels + c];
+			for (size_t k = i > bandwidth ? i - bandwidth : 0; k < i; k++)
+				sum -= L(i, k) * b[k * channels + c];
+			b[i * channels + c] = sum / L(i, i);
+		}
+		for (size_t i = n; i-- > 0;) //L^T*x = y
+		{
+			double sum = b[i * channels + c];
+			for (size_t k = i + 1; k < n && k <= i + bandwidth; k++)
+				sum -= L(k, i) * b[k * channels + c];
+			b[i * channels + c] = sum / L(i, i);
+		}
+	}
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+//Cholesky solve of a symmetric positive definite banded system stored as its lower band, band[i * (bandwidth + 1) + d] holds A(i, i - d).
+//b holds channels right hand sides per row and is overwritten with the solution, memory and time are linear in n
+void SolveBanded(std::vector<double>& band, std::vector<double>& b, size_t n, size_t bandwidth, size_t channels);
@@ -0,0 +1,153 @@
+#include "batchsimulator.h"
+#include <thread>
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <stdexcept>
+#include "serialization.h"
+#include "pathtiming.h"
+#include "interpstrategies/strategyfactory.h"
+#include "interpstrategies/linearinterp.h"
+
+struct WorkerQueue
+{
+	std::mutex mutex;
+	std::deque<size_t> jobs;
+};
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+BatchSimulator::BatchSimulator(BatchSettings _settings) : settings(_settings)
+{
+}
+
+std::string BatchSimulator::GetTrackFile(const std::string& pathFile) const
+{
+	size_t nameStart = pathFile.find_last_of("/\\");
+	std::string name = nameStart == std::string::npos ? pathFile : pathFile.substr(nameStart + 1);
+	size_t extension = name.find_last_of('.');
+	if (extension != std::string::npos)
+		name = name.substr(0, extension);
+	return settings.outputDirectory + "/" + name + (settings.format == MOCK_OUTPUT_BINARY ? ".bin" : ".csv");
+}
+
+BatchResult BatchSimulator::SimulatePath(const std::string& pathFile)
+{
+	BatchResult result;
+	result.pathFile = pathFile;
+	result.trackFile = GetTrackFile(pathFile);
+	try
+	{
+		auto start = std::chrono::steady_clock::now();
+		auto path = std::make_shared<savetype>(LoadPathFromFile(pathFile));
+		result.loadMs = MillisecondsSince(start);
+		result.snapshots = path->size();
+		if (path->size() < 2)
+		{
+			result.error = "path needs at least 2 snapshots";
+			return result;
+		}
+
+		start = std::chrono::steady_clock::now();
+		auto locationStrategy = CreateInterpStrategy(settings.locationInterpMode, path, settings.chaikinDegree, settings.splineAccuracy);
+		if (!locationStrategy)
+			locationStrategy = std::make_shared<LinearInterpStrategy>(LinearInterpStrategy(path, settings.chaikinDegree));
+		auto rotationStrategy = locationStrategy;
+		if (settings.rotationInterpMode != settings.locationInterpMode)
+		{
+			rotationStrategy = CreateInterpStrategy(settings.rotationInterpMode, path, settings.chaikinDegree, settings.splineAccuracy);
+			if (!rotationStrategy)
+				rotationStrategy = std::make_shared<LinearInterpStrategy>(LinearInterpStrategy(path, settings.chaikinDegree));
+		}
+		result.buildMs = MillisecondsSince(start);
+
+		start = std::chrono::steady_clock::now();
+		MockGameApplier applier(result.trackFile, settings.format);
+		auto frameTimes = BuildFrameTimes(*path, 1.f / settings.replayFPS);
+		int startFrame = path->begin()->first;
+		for (size_t i = 0; i < frameTimes.size(); i++)
+		{
+			int frame = startFrame + (int)i;
+			NewPOV pov = locationStrategy->GetPOV(frameTimes[i], frame);
+			if (rotationStrategy != locationStrategy)
+			{
+				NewPOV secondaryPov = rotationStrategy->GetPOV(frameTimes[i], frame);
+				pov.rotation = secondaryPov.rotation;
+				pov.FOV = secondaryPov.FOV;
+			}
+			if (pov.FOV < 1) //Invalid camerastate
+				continue;
+			applier.SetTime(frameTimes[i]);
+			applier.SetPOV(pov.location, pov.rotation, pov.FOV);
+		}
+		applier.Flush();
+		result.frames = frameTimes.size();
+		result.simulateMs = MillisecondsSince(start);
+		result.success = true;
+	}
+	catch (const std::exception& e)
+	{
+		result.error = e.what();
+	}
+	return result;
+}
+
+std::vector<BatchResult> BatchSimulator::Run(const std::vector<std::string>& pathFiles)
+{
+	std::vector<BatchResult> results(pathFiles.size());
+	unsigned int workerCount = settings.threads > 0 ? settings.threads : std::thread::hardware_concurrency();
+	if (workerCount == 0)
+		workerCount = 1;
+	if (workerCount > pathFiles.size())
+		workerCount = (unsigned int)pathFiles.size();
+	if (workerCount == 0)
+		return results;
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	for (unsigned int i = 0; i < workerCount; i++)
+		queues.push_back(std::make_unique<WorkerQueue>());
+	for (size_t i = 0; i < pathFiles.size(); i++)
+		queues[i % workerCount]->jobs.push_back(i);
+
+	auto worker = [&](unsigned int id)
+	{
+		while (true)
+		{
+			size_t job = pathFiles.size();
+			{
+				std::lock_guard<std::mutex> lock(queues[id]->mutex);
+				if (!queues[id]->jobs.empty())
+				{
+					job = queues[id]->jobs.back();
+					queues[id]->jobs.pop_back();
+				}
+			}
+			for (unsigned int offset = 1; job == pathFiles.size() && offset < workerCount; offset++) //Own queue is empty, steal the oldest job of another worker
+			{
+				WorkerQueue& victim = *queues[(id + offset) % workerCount];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (!victim.jobs.empty())
+				{
+					job = victim.jobs.front();
+					victim.jobs.pop_front();
+				}
+			}
+			if (job == pathFiles.size()) //No jobs are added while running, so everything is done
+				return;
+
+			results[job] = SimulatePath(pathFiles[job]);
+			results[job].worker = id;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < workerCount; i++)
+		threads.emplace_back(worker, i);
+	worker(0);
+	for (auto& thread : threads)
+		thread.join();
+	return results;
+}
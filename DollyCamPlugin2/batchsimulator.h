@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "gameapplier.h"
+
+struct BatchSettings
+{
+	int locationInterpMode = 5;
+	int rotationInterpMode = 5;
+	int chaikinDegree = 0;
+	int splineAccuracy = 1000;
+	float replayFPS = 30.f;
+	unsigned int threads = 0; //0 uses one worker per hardware thread
+	MockOutputFormat format = MOCK_OUTPUT_CSV;
+	std::string outputDirectory = ".";
+};
+
+struct BatchResult
+{
+	std::string pathFile;
+	std::string trackFile;
+	bool success = false;
+	std::string error;
+	unsigned int worker = 0;
+	size_t snapshots = 0;
+	size_t frames = 0;
+	double loadMs = 0;
+	double buildMs = 0;
+	double simulateMs = 0;
+};
+
+//Simulates playback of saved paths without the game, writing a camera track per path through a MockGameApplier.
+//Paths are spread over a pool of workers that steal from each other once their own queue is empty.
+class BatchSimulator
+{
+private:
+	BatchSettings settings;
+	std::string GetTrackFile(const std::string& pathFile) const;
+	BatchResult SimulatePath(const std::string& pathFile);
+
+public:
+	BatchSimulator(BatchSettings settings);
+	//Results are in the same order as the given path files
+	std::vector<BatchResult> Run(const std::vector<std::string>& pathFiles);
+};
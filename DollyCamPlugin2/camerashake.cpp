@@ -0,0 +1,100 @@
+#include "camerashake.h"
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#define NOISE_PERIODS 64 //Lattice points in a table, the noise repeats after this many cycles of a layer
+#define SAMPLES_PER_PERIOD 16
+#define TABLE_SIZE (NOISE_PERIODS * SAMPLES_PER_PERIOD)
+#define MAX_LAYERS 8
+
+static float Fade(float t)
+{
+	return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+void CameraShake::BuildTables()
+{
+	std::mt19937 generator(settings.seed);
+	std::uniform_real_distribution<float> gradientDistribution(-1.f, 1.f);
+	std::vector<float> gradients(NOISE_PERIODS);
+	for (int channel = 0; channel < CHANNEL_COUNT; channel++)
+	{
+		for (auto& gradient : gradients)
+			gradient = gradientDistribution(generator);
+
+		tables[channel].resize(TABLE_SIZE);
+		for (int i = 0; i < TABLE_SIZE; i++)
+		{
+			int lattice = i / SAMPLES_PER_PERIOD;
+			float t = (i % SAMPLES_PER_PERIOD) / (float)SAMPLES_PER_PERIOD;
+			float from = gradients[lattice] * t;
+			float to = gradients[(lattice + 1) % NOISE_PERIODS] * (t - 1);
+			//1-D Perlin noise stays within half the gradient range
+			tables[channel][i] = (from + (to - from) * Fade(t)) * 2;
+		}
+	}
+
+	std::uniform_real_distribution<float> offsetDistribution(0.f, (float)TABLE_SIZE);
+	layerOffsets.resize(MAX_LAYERS);
+	for (auto& offset : layerOffsets)
+		offset = offsetDistribution(generator);
+	tablesBuilt = true;
+}
+
+void CameraShake::SetSettings(const ShakeSettings& _settings)
+{
+	bool seedChanged = _settings.seed != settings.seed;
+	settings = _settings;
+	settings.layers = (std::max)(1, (std::min)(settings.layers, MAX_LAYERS));
+	settings.frequency = (std::max)(0.f, settings.frequency);
+	if (!tablesBuilt || seedChanged)
+		BuildTables();
+
+	float amplitudeSum = 0;
+	for (int layer = 0; layer < settings.layers; layer++)
+		amplitudeSum += ldexp(1.f, -layer);
+	amplitudeScale = 1.f / amplitudeSum;
+}
+
+bool CameraShake::IsEnabled() const
+{
+	return tablesBuilt && (settings.location > 0 || settings.rotation > 0 || settings.FOV > 0);
+}
+
+float CameraShake::Sample(int channel, float time) const
+{
+	const std::vector<float>& table = tables[channel];
+	float value = 0;
+	float frequency = settings.frequency;
+	float amplitude = amplitudeScale;
+	for (int layer = 0; layer < settings.layers; layer++)
+	{
+		float position = fmod(time * frequency * SAMPLES_PER_PERIOD + layerOffsets[layer], (float)TABLE_SIZE);
+		if (position < 0)
+			position += TABLE_SIZE;
+		int index = (int)position;
+		float t = position - index;
+		float from = table[index % TABLE_SIZE];
+		float to = table[(index + 1) % TABLE_SIZE];
+		value += (from + (to - from) * t) * amplitude;
+		frequency *= 2;
+		amplitude *= .5f;
+	}
+	return value;
+}
+
+void CameraShake::Apply(NewPOV& pov, float time) const
+{
+	if (!IsEnabled())
+		return;
+	if (settings.location > 0)
+		pov.location = pov.location + Vector(Sample(CHANNEL_X, time), Sample(CHANNEL_Y, time), Sample(CHANNEL_Z, time)) * settings.location;
+	if (settings.rotation > 0)
+	{
+		float scale = settings.rotation * ROTATOR_UNITS_PER_DEGREE;
+		pov.rotation = pov.rotation + CustomRotator(Sample(CHANNEL_PITCH, time) * scale, Sample(CHANNEL_YAW, time) * scale, Sample(CHANNEL_ROLL, time) * scale);
+	}
+	if (settings.FOV > 0)
+		pov.FOV = (std::max)(1.f, pov.FOV + Sample(CHANNEL_FOV, time) * settings.FOV);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "models.h"
+
+struct ShakeSettings
+{
+	float location = 0.f; //Unreal units
+	float rotation = 0.f; //Degrees
+	float FOV = 0.f;
+	float frequency = 1.f; //Hz of the slowest layer
+	int layers = 3; //Every layer doubles the frequency and halves the amplitude of the previous one
+	int seed = 0;
+};
+
+//Handheld style noise added on top of the evaluated camera state.
+//Every channel has its own table of 1-D Perlin noise built from the seed, so shaking the camera is a few table lookups per tick
+class CameraShake
+{
+private:
+	enum Channel
+	{
+		CHANNEL_X,
+		CHANNEL_Y,
+		CHANNEL_Z,
+		CHANNEL_PITCH,
+		CHANNEL_YAW,
+		CHANNEL_ROLL,
+		CHANNEL_FOV,
+		CHANNEL_COUNT
+	};
+
+	ShakeSettings settings;
+	bool tablesBuilt = false;
+	std::vector<float> tables[CHANNEL_COUNT];
+	std::vector<float> layerOffsets; //Where every layer starts reading, so layers of the same channel aren't correlated
+	float amplitudeScale = 1.f; //Keeps the sum of every layer within the requested amplitude
+
+	void BuildTables();
+	float Sample(int channel, float time) const;
+
+public:
+	void SetSettings(const ShakeSettings& settings);
+	bool IsEnabled() const;
+	//Time is in seconds, the same time always gives the same offset so scrubbing the replay is repeatable
+	void Apply(NewPOV& pov, float time) const;
+};
@@ -0,0 +1,371 @@
+#include "collisionmesh.h"
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cfloat>
+#include <algorithm>
+
+#define LEAF_TRIANGLES 4
+#define MAX_PUSH_ITERATIONS 4 //Corners need a push for every surface the camera is close to
+#define PUSH_EPSILON .01f
+
+static float Axis(const Vector& v, int axis)
+{
+	return axis == 0 ? v.X : (axis == 1 ? v.Y : v.Z);
+}
+
+static Vector Min(const Vector& a, const Vector& b)
+{
+	return Vector((std::min)(a.X, b.X), (std::min)(a.Y, b.Y), (std::min)(a.Z, b.Z));
+}
+
+static Vector Max(const Vector& a, const Vector& b)
+{
+	return Vector((std::max)(a.X, b.X), (std::max)(a.Y, b.Y), (std::max)(a.Z, b.Z));
+}
+
+static float DistanceSquaredToBox(const Vector& point, const Vector& min, const Vector& max)
+{
+	float distance = 0;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float value = Axis(point, axis);
+		float outside = (std::max)((std::max)(Axis(min, axis) - value, 0.f), value - Axis(max, axis));
+		distance += outside * outside;
+	}
+	return distance;
+}
+
+//Real-Time Collision Detection, Ericson, 5.1.5
+static Vector ClosestPointOnTriangle(const Vector& p, const Vector& a, const Vector& b, const Vector& c)
+{
+	Vector ab = b - a;
+	Vector ac = c - a;
+	Vector ap = p - a;
+	float d1 = Vector::dot(ab, ap);
+	float d2 = Vector::dot(ac, ap);
+	if (d1 <= 0 && d2 <= 0)
+		return a;
+
+	Vector bp = p - b;
+	float d3 = Vector::dot(ab, bp);
+	float d4 = Vector::dot(ac, bp);
+	if (d3 >= 0 && d4 <= d3)
+		return b;
+
+	float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0 && d1 >= 0 && d3 <= 0)
+		return a + ab * (d1 / (d1 - d3));
+
+	Vector cp = p - c;
+	float d5 = Vector::dot(ab, cp);
+	float d6 = Vector::dot(ac, cp);
+	if (d6 >= 0 && d5 <= d6)
+		return c;
+
+	float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0 && d2 >= 0 && d6 <= 0)
+		return a + ac * (d2 / (d2 - d6));
+
+	float va = d3 * d6 - d5 * d4;
+	if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	float denominator = 1.f / (va + vb + vc);
+	return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+//Parses the vertex index of a face corner ("7", "7/1" or "7/1/3"), negative indices count back from the last vertex
+static bool ParseFaceIndex(const std::string& token, size_t vertexCount, size_t& index)
+{
+	int value = atoi(token.c_str());
+	if (value > 0 && (size_t)value <= vertexCount)
+		index = value - 1;
+	else if (value < 0 && (size_t)(-value) <= vertexCount)
+		index = vertexCount + value;
+	else
+		return false;
+	return true;
+}
+
+bool CollisionMesh::LoadFromFile(std::string filename)
+{
+	std::ifstream file(filename);
+	if (!file.is_open())
+		return false;
+
+	std::vector<Vector> vertices;
+	std::vector<Triangle> loaded;
+	std::string line;
+	std::vector<size_t> face;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		std::string type;
+		stream >> type;
+		if (type == "v")
+		{
+			float x = 0, y = 0, z = 0;
+			stream >> x >> y >> z;
+			vertices.push_back(Vector(x, y, z));
+		}
+		else if (type == "f")
+		{
+			face.clear();
+			std::string token;
+			size_t index;
+			bool valid = true;
+			while (stream >> token)
+			{
+				valid = valid && ParseFaceIndex(token, vertices.size(), index);
+				face.push_back(index);
+			}
+			if (!valid)
+				continue;
+			//Polygons are split into a fan
+			for (size_t i = 2; i < face.size(); i++)
+			{
+				Triangle triangle;
+				triangle.a = vertices[face[0]];
+				triangle.b = vertices[face[i - 1]];
+				triangle.c = vertices[face[i]];
+				Vector normal = Vector::cross(triangle.b - triangle.a, triangle.c - triangle.a);
+				float length = sqrt(Vector::dot(normal, normal));
+				if (length < 1e-6f)
+					continue;
+				triangle.normal = normal * (1.f / length);
+				loaded.push_back(triangle);
+			}
+		}
+	}
+	if (loaded.empty())
+		return false;
+
+	triangles = loaded;
+	nodes.clear();
+	nodes.reserve(2 * triangles.size() / LEAF_TRIANGLES + 1);
+	std::vector<int> order(triangles.size());
+	std::vector<Vector> centroids(triangles.size());
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		order[i] = (int)i;
+		centroids[i] = (triangles[i].a + triangles[i].b + triangles[i].c) * (1.f / 3.f);
+	}
+	BuildNode(order, centroids, 0, (int)triangles.size());
+
+	//Leaves point at ranges of the sorted order, store the triangles in that order
+	std::vector<Triangle> sorted;
+	sorted.reserve(triangles.size());
+	for (int index : order)
+		sorted.push_back(triangles[index]);
+	triangles.swap(sorted);
+	return true;
+}
+
+int CollisionMesh::BuildNode(std::vector<int>& order, std::vector<Vector>& centroids, int first, int count)
+{
+	int index = (int)nodes.size();
+	nodes.push_back(Node());
+
+	Vector min(FLT_MAX, FLT_MAX, FLT_MAX), max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	Vector centroidMin = min, centroidMax = max;
+	for (int i = first; i < first + count; i++)
+	{
+		const Triangle& triangle = triangles[order[i]];
+		min = Min(min, Min(triangle.a, Min(triangle.b, triangle.c)));
+		max = Max(max, Max(triangle.a, Max(triangle.b, triangle.c)));
+		centroidMin = Min(centroidMin, centroids[order[i]]);
+		centroidMax = Max(centroidMax, centroids[order[i]]);
+	}
+	nodes[index].min = min;
+	nodes[index].max = max;
+	if (count <= LEAF_TRIANGLES)
+	{
+		nodes[index].first = first;
+		nodes[index].count = count;
+		return index;
+	}
+
+	//Median split along the widest spread of centroids
+	Vector extent = centroidMax - centroidMin;
+	int axis = extent.X > extent.Y ? (extent.X > extent.Z ? 0 : 2) : (extent.Y > extent.Z ? 1 : 2);
+	int middle = first + count / 2;
+	std::nth_element(order.begin() + first, order.begin() + middle, order.begin() + first + count,
+		[&](int a, int b) { return Axis(centroids[a], axis) < Axis(centroids[b], axis); });
+
+	BuildNode(order, centroids, first, middle - first);
+	int right = BuildNode(order, centroids, middle, first + count - middle);
+	nodes[index].first = right;
+	return index;
+}
+
+void CollisionMesh::Clear()
+{
+	triangles.clear();
+	nodes.clear();
+}
+
+bool CollisionMesh::IsEmpty() const
+{
+	return nodes.empty();
+}
+
+size_t CollisionMesh::GetTriangleCount() const
+{
+	return triangles.size();
+}
+
+size_t CollisionMesh::GetNodeCount() const
+{
+	return nodes.size();
+}
+
+int CollisionMesh::FindClosest(const Vector& point, float maxDistance, Vector& closest) const
+{
+	if (nodes.empty())
+		return -1;
+	int best = -1;
+	float bestDistance = maxDistance * maxDistance;
+	stack.clear();
+	stack.push_back(0);
+	while (!stack.empty())
+	{
+		int index = stack.back();
+		stack.pop_back();
+		const Node& node = nodes[index];
+		if (DistanceSquaredToBox(point, node.min, node.max) >= bestDistance)
+			continue;
+		if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				Vector candidate = ClosestPointOnTriangle(point, triangles[i].a, triangles[i].b, triangles[i].c);
+				Vector offset = point - candidate;
+				float distance = Vector::dot(offset, offset);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					closest = candidate;
+					best = i;
+				}
+			}
+			continue;
+		}
+		//Visit the nearer child first so the search radius shrinks sooner
+		int left = index + 1, right = node.first;
+		if (DistanceSquaredToBox(point, nodes[left].min, nodes[left].max) < DistanceSquaredToBox(point, nodes[right].min, nodes[right].max))
+			std::swap(left, right);
+		stack.push_back(left);
+		stack.push_back(right);
+	}
+	return best;
+}
+
+int CollisionMesh::Raycast(const Vector& from, const Vector& to, Vector& hit) const
+{
+	if (nodes.empty())
+		return -1;
+	Vector direction = to - from;
+	float inverse[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float value = Axis(direction, axis);
+		inverse[axis] = fabs(value) > 1e-9f ? 1.f / value : (value < 0 ? -FLT_MAX : FLT_MAX);
+	}
+
+	int best = -1;
+	float bestT = 1.f;
+	stack.clear();
+	stack.push_back(0);
+	while (!stack.empty())
+	{
+		int index = stack.back();
+		stack.pop_back();
+		const Node& node = nodes[index];
+
+		float tMin = 0, tMax = bestT;
+		for (int axis = 0; axis < 3 && tMin <= tMax; axis++)
+		{
+			float t0 = (Axis(node.min, axis) - Axis(from, axis)) * inverse[axis];
+			float t1 = (Axis(node.max, axis) - Axis(from, axis)) * inverse[axis];
+			if (t0 > t1)
+				std::swap(t0, t1);
+			tMin = (std::max)(tMin, t0);
+			tMax = (std::min)(tMax, t1);
+		}
+		if (tMin > tMax)
+			continue;
+
+		if (node.count == 0)
+		{
+			stack.push_back(index + 1);
+			stack.push_back(node.first);
+			continue;
+		}
+		//Moller-Trumbore
+		for (int i = node.first; i < node.first + node.count; i++)
+		{
+			const Triangle& triangle = triangles[i];
+			Vector edge1 = triangle.b - triangle.a;
+			Vector edge2 = triangle.c - triangle.a;
+			Vector p = Vector::cross(direction, edge2);
+			float determinant = Vector::dot(edge1, p);
+			if (fabs(determinant) < 1e-9f)
+				continue;
+			float inverseDeterminant = 1.f / determinant;
+			Vector s = from - triangle.a;
+			float u = Vector::dot(s, p) * inverseDeterminant;
+			if (u < 0 || u > 1)
+				continue;
+			Vector q = Vector::cross(s, edge1);
+			float v = Vector::dot(direction, q) * inverseDeterminant;
+			if (v < 0 || u + v > 1)
+				continue;
+			float t = Vector::dot(edge2, q) * inverseDeterminant;
+			if (t >= 0 && t < bestT)
+			{
+				bestT = t;
+				best = i;
+			}
+		}
+	}
+	if (best >= 0)
+		hit = from + direction * bestT;
+	return best;
+}
+
+bool CollisionMesh::PushOut(Vector& location, float radius, const Vector* previous) const
+{
+	if (nodes.empty())
+		return false;
+	bool collided = false;
+	Vector hit;
+	if (previous)
+	{
+		int triangle = Raycast(*previous, location, hit);
+		//Only crossing from the open side into the geometry counts, leaving it is the push below doing its job
+		if (triangle >= 0 && Vector::dot(location - *previous, triangles[triangle].normal) < 0)
+		{
+			location = hit + triangles[triangle].normal * radius;
+			collided = true;
+		}
+	}
+
+	Vector closest;
+	for (int iteration = 0; iteration < MAX_PUSH_ITERATIONS; iteration++)
+	{
+		int triangle = FindClosest(location, radius - PUSH_EPSILON, closest);
+		if (triangle < 0)
+			break;
+		Vector offset = location - closest;
+		float distance = sqrt(Vector::dot(offset, offset));
+		const Vector& normal = triangles[triangle].normal;
+		if (distance < PUSH_EPSILON || Vector::dot(offset, normal) < 0)
+			location = closest + normal * radius;
+		else
+			location = closest + offset * (radius / distance);
+		collided = true;
+	}
+	return collided;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "models.h"
+
+//Arena geometry loaded from a Wavefront .obj file, with a bounding volume hierarchy built once at load time.
+//Triangle normals (counter clockwise winding) are expected to face the playable space, a camera behind a triangle is inside geometry
+class CollisionMesh
+{
+private:
+	struct Triangle
+	{
+		Vector a;
+		Vector b;
+		Vector c;
+		Vector normal;
+	};
+
+	struct Node
+	{
+		Vector min;
+		Vector max;
+		int first = 0; //First triangle of a leaf, right child of an inner node (the left child follows the node)
+		int count = 0; //Triangles in a leaf, 0 for inner nodes
+	};
+
+	std::vector<Triangle> triangles;
+	std::vector<Node> nodes;
+	mutable std::vector<int> stack;
+
+	int BuildNode(std::vector<int>& order, std::vector<Vector>& centroids, int first, int count);
+	//Closest point on the mesh within maxDistance, returns the triangle index or -1
+	int FindClosest(const Vector& point, float maxDistance, Vector& closest) const;
+	//First triangle hit by the segment, returns the triangle index or -1
+	int Raycast(const Vector& from, const Vector& to, Vector& hit) const;
+
+public:
+	bool LoadFromFile(std::string filename);
+	void Clear();
+	bool IsEmpty() const;
+	size_t GetTriangleCount() const;
+	size_t GetNodeCount() const;
+	//Moves location out of the geometry so it stays radius away from it.
+	//Passing the location of the previous frame also catches cameras that went through a wall in between
+	bool PushOut(Vector& location, float radius, const Vector* previous = nullptr) const;
+};
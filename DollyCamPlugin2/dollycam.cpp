@@ -5,54 +5,106 @@
 #include "utils/parser.h"
 
 #include "interpstrategies\supportedstrategies.h"
+#include "interpstrategies\strategyfactory.h"
 #include "serialization.h"
+#include "pathreducer.h"
+#include "pathoptimizer.h"
+#include "pathtiming.h"
+#include "profiler.h"
+#include "tracing.h"
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <chrono>
 
+#define LIBRARY_DEFAULT_CACHE (64 * 1024 * 1024)
+
+
+void DollyCam::UpdateFrameTimes()
+{
+	if (gameWrapper->IsInReplay())
+		replayTickRate = 1.f / (float)gameWrapper->GetGameEventAsReplay().GetReplayFPS();
+	frameTimeTable.Build(*currentPath, replayTickRate);
+	frameTimesRevision = pathRevision;
+}
+
+const FrameTimeTable& DollyCam::GetFrameTimeTable()
+{
+	if (frameTimesRevision != pathRevision)
+		UpdateFrameTimes();
+	return frameTimeTable;
+}
 
 void DollyCam::UpdateRenderPath()
 {
+	ScopedTimer timer(PROFILE_UPDATE_RENDER_PATH);
+	TRACE_SCOPE("UpdateRenderPath");
 	if (!gameWrapper->IsInReplay())
 		return;
 	currentRenderPath = make_shared<savetype>(savetype());
-	CVarWrapper interpMode = cvarManager->getCvar("dolly_interpmode_location");
-	auto locationRenderStrategy = CreateInterpStrategy(interpMode.getIntValue());
-	auto firstFrame = currentPath->begin();
-	float beginTime = firstFrame->second.timeStamp;
-
-	int startFrame = firstFrame->first;
-	int endFrame = (--currentPath->end())->first;
-
-	float replayTickRate = 1.f / (float)gameWrapper->GetGameEventAsReplay().GetReplayFPS();
-
-	int lastSyncedFrame = startFrame;
-	float timePerFrame = replayTickRate;
-	for (int i = startFrame; i <= endFrame; i++)
+	renderPathMotion.Clear();
+	if (currentPath->empty())
 	{
-		if (currentPath->find(i) != currentPath->end())
-		{
-			lastSyncedFrame = i;
-			auto currentSnapshot = currentPath->find(i);
-			beginTime = currentSnapshot->second.timeStamp;
-			timePerFrame = replayTickRate;
-			//auto nextSnapshot = currentPath->upper_bound(i);
-			//timePerFrame = (nextSnapshot->second.timeStamp - beginTime) / (nextSnapshot->second.frame - currentSnapshot->second.frame);
-			//if (timePerFrame < .01f || timePerFrame > .08f) //outliers
-			//	timePerFrame = replayTickRate;
-		}
-
-
+		pathRenderer.SetPath(*currentRenderPath, *currentPath, renderPathMotion);
+		return;
+	}
+	//Every change to the current path rebuilds the location strategy before getting here (LoadFromLibrary installs
+	//the cached strategies of the path it copies), so it always matches the current path and can be reused
+	auto locationRenderStrategy = locationInterpStrategy;
+	if (!locationRenderStrategy)
+		locationRenderStrategy = CreateInterpStrategy(cvarManager->getCvar("dolly_interpmode_location").getIntValue());
 
+	int startFrame = currentPath->begin()->first;
+	UpdateFrameTimes();
+	const auto& frameTimes = frameTimeTable.GetTimes();
+	std::vector<MotionDerivatives> sampleDerivatives;
+	sampleDerivatives.reserve(frameTimes.size());
+	for (size_t index = 0; index < frameTimes.size(); index++)
+	{
+		int i = startFrame + index;
 		CameraSnapshot snapshot;
 		snapshot.frame = i;
-		snapshot.timeStamp = beginTime + (timePerFrame * (i - lastSyncedFrame));
-		NewPOV pov = locationRenderStrategy->GetPOV(snapshot.timeStamp, i);
+		snapshot.timeStamp = frameTimes[index];
+		//Derivatives come out of the same evaluation, the motion analysis doesn't sample the path again
+		MotionDerivatives derivatives;
+		NewPOV pov = locationRenderStrategy->GetPOVAndDerivatives(snapshot.timeStamp, i, derivatives);
 		snapshot.location = pov.location;
 		snapshot.rotation = pov.rotation;
 		snapshot.FOV = pov.FOV;
 
 		if (snapshot.FOV > 1)
+		{
 			currentRenderPath->insert(make_pair(i, snapshot));
+			sampleDerivatives.push_back(derivatives);
+		}
 
 	}
+	collidingFrames.clear();
+	if (avoidCollisions && !collisionMesh.IsEmpty())
+	{
+		auto start = std::chrono::steady_clock::now();
+		collidingFrames = PushOutPath(*currentRenderPath);
+		collisionMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	//Motion of the path as it plays, the frames that were pushed out no longer follow the strategy's derivatives
+	size_t sampleIndex = 0, pushedIndex = 0;
+	for (const auto& item : *currentRenderPath)
+	{
+		MotionDerivatives& derivatives = sampleDerivatives[sampleIndex++];
+		if (pushedIndex < collidingFrames.size() && collidingFrames[pushedIndex] == item.first)
+		{
+			derivatives.valid = false;
+			pushedIndex++;
+		}
+		NewPOV pov;
+		pov.location = item.second.location;
+		pov.rotation = item.second.rotation;
+		pov.FOV = item.second.FOV;
+		renderPathMotion.AddSample(item.first, item.second.timeStamp, pov, derivatives);
+	}
+	renderPathMotion.Finish();
+	pathRenderer.SetPath(*currentRenderPath, *currentPath, renderPathMotion);
 }
 
 void DollyCam::CheckIfSameInterp()
@@ -61,6 +113,7 @@ void DollyCam::CheckIfSameInterp()
 }
 
 DollyCam::DollyCam(std::shared_ptr<GameWrapper> _gameWrapper, std::shared_ptr<CVarManagerWrapper> _cvarManager, std::shared_ptr<IGameApplier> _gameApplier)
+	: library(std::bind(&DollyCam::BuildLibraryTrack, this, std::placeholders::_1), LIBRARY_DEFAULT_CACHE)
 {
 	currentPath = std::unique_ptr<savetype>(new savetype());
 	gameWrapper = _gameWrapper;
@@ -127,11 +180,21 @@ void DollyCam::Deactivate()
 	cvarManager->log("Dollycam deactivated");
 }
 
-float lastWrite = -5000.f;
-float diff = .0f;
-bool isFirst = true;
+float DollyCam::GetFrameFraction(float secondsElapsed, int currentFrame)
+{
+	//Replay frames tick slower than the game renders, time since the frame changed gives the position between two frames
+	if (currentFrame != lastAppliedFrame)
+	{
+		lastAppliedFrame = currentFrame;
+		frameStartSeconds = secondsElapsed;
+	}
+	return (std::max)(0.f, (std::min)((secondsElapsed - frameStartSeconds) / replayTickRate, .999f));
+}
+
 void DollyCam::Apply()
 {
+	ScopedTimer timer(PROFILE_APPLY);
+	TRACE_SCOPE("Apply");
 	int currentFrame = 0;
 	ServerWrapper sw(NULL);
 	if (gameWrapper->IsInReplay()) {
@@ -146,32 +209,203 @@ void DollyCam::Apply()
 	{
 		return;
 	}
-	if (currentFrame < currentPath->begin()->first || currentFrame >(--currentPath->end())->first)
+	if (playBakedTrack && bakedTrack)
+	{
+		if (bakedRevision != evaluationRevision && !warnedOutdatedBake)
+		{
+			cvarManager->log("The path changed since it was baked, playing the old bake. Use dolly_bake to update it");
+			warnedOutdatedBake = true;
+		}
+		//Look-at, shake and collisions were baked in, the frame goes to the game as is
+		NewPOV pov;
+		if (bakedTrack->GetFrame(currentFrame, pov))
+			gameApplier->SetPOV(pov.location, pov.rotation, pov.FOV);
 		return;
-	if (currentFrame == currentPath->begin()->first)
+	}
+	if (playTracks)
 	{
-		if (isFirst) {
-			diff = sw.GetSecondsElapsed();
-
-			isFirst = false;
+		float fraction = GetFrameFraction(sw.GetSecondsElapsed(), currentFrame);
+		NewPOV pov;
+		if (const TrackBlend* blend = FindBlend(currentFrame))
+		{
+			pov = blend->Evaluate(currentFrame + fraction, currentFrame);
+		}
+		else if (const PathTrack* track = FindTrack(currentFrame))
+		{
+			pov = track->Evaluate(track->frameTimes.GetTime(currentFrame + fraction), currentFrame);
 		}
+		else
+		{
+			return;
+		}
+		if (pov.FOV >= 1)
+			SetPOV(pov, currentFrame + fraction);
+		return;
 	}
-	else {
-		isFirst = true;
+	if (currentPath->empty())
+		return;
+	int pathFrame = (int)floor(timeRemap.Map((float)currentFrame));
+	if (pathFrame < currentPath->begin()->first || pathFrame >(--currentPath->end())->first)
+		return;
+
+	float fraction = GetFrameFraction(sw.GetSecondsElapsed(), currentFrame);
+	NewPOV pov = EvaluateFrame(currentFrame + fraction);
+	if (pov.FOV < 1) { //Invalid camerastate
+		return;
 	}
+	SetPOV(pov, currentFrame + fraction);
+	//flyCam.SetPOV(pov.ToPOV());
+}
 
-	NewPOV pov = locationInterpStrategy->GetPOV(sw.GetSecondsElapsed() - diff + currentPath->begin()->second.timeStamp, currentFrame);
-	if (!usesSameInterp)
+void DollyCam::SetPOV(NewPOV pov, float frame)
+{
+	if (avoidCollisions)
 	{
-		NewPOV secondaryPov = rotationInterpStrategy->GetPOV(sw.GetSecondsElapsed() - diff + currentPath->begin()->second.timeStamp, currentFrame);
+		//Only continuous playback can have passed through a wall since the last frame, not a jump in the replay
+		bool continuous = lastCameraFrame >= 0 && frame > lastCameraFrame && frame - lastCameraFrame <= 2;
+		collisionMesh.PushOut(pov.location, collisionRadius, continuous ? &lastCameraLocation : nullptr);
+		lastCameraLocation = pov.location;
+		lastCameraFrame = frame;
+	}
+	AddLookAtAndShake(pov, frame);
+	gameApplier->SetPOV(pov.location, pov.rotation, pov.FOV);
+}
+
+void DollyCam::AddLookAtAndShake(NewPOV& pov, float frame)
+{
+	//Aim from where the camera ends up after being pushed out
+	Vector target;
+	if (lookAtTarget && targetTrack.GetTarget(frame, target))
+		pov.rotation = LookAtRotation(pov.location, target, pov.rotation);
+	//The fraction between replay frames comes from the wall clock, sample the shake on the whole frame so every playback gets the same noise
+	shake.Apply(pov, (float)floor(frame) * replayTickRate);
+}
+
+std::vector<int> DollyCam::PushOutPath(savetype& path)
+{
+	std::vector<int> frames;
+	const Vector* previous = nullptr;
+	for (auto& item : path)
+	{
+		if (collisionMesh.PushOut(item.second.location, collisionRadius, previous))
+			frames.push_back(item.first);
+		previous = &item.second.location;
+	}
+	return frames;
+}
+
+NewPOV DollyCam::EvaluateFrame(float frame)
+{
+	float pathFrame = timeRemap.Map(frame);
+	return EvaluatePOV(GetFrameTimeTable().GetTime(pathFrame), (int)floor(pathFrame));
+}
+
+NewPOV DollyCam::EvaluatePOV(float time, int frame)
+{
+	ScopedTimer timer(PROFILE_GETPOV);
+	NewPOV pov = locationInterpStrategy->GetPOV(time, frame);
+	if (!usesSameInterp && rotationInterpStrategy)
+	{
+		NewPOV secondaryPov = rotationInterpStrategy->GetPOV(time, frame);
 		pov.rotation = secondaryPov.rotation;
 		pov.FOV = secondaryPov.FOV;
 	}
-	if (pov.FOV < 1) { //Invalid camerastate
-		return;
+	return pov;
+}
+
+bool DollyCam::Bake()
+{
+	if (!gameWrapper->IsInReplay() || currentPath->size() < 2 || !locationInterpStrategy)
+		return false;
+
+	//Replay frames are remapped before evaluating, bake every replay frame that lands on the path
+	int startFrame, endFrame;
+	if (!timeRemap.FindFrameRange((float)currentPath->begin()->first, (float)(--currentPath->end())->first, startFrame, endFrame))
+		return false;
+	bakedTrack = std::make_shared<BakedTrack>(startFrame);
+	//Playback sends the baked frames to the game as they are, so the layers SetPOV adds are baked in too
+	Vector previousLocation;
+	bool hasPrevious = false;
+	for (int frame = startFrame; frame <= endFrame; frame++)
+	{
+		NewPOV pov = EvaluateFrame((float)frame);
+		if (pov.FOV >= 1)
+		{
+			if (avoidCollisions)
+			{
+				collisionMesh.PushOut(pov.location, collisionRadius, hasPrevious ? &previousLocation : nullptr);
+				previousLocation = pov.location;
+				hasPrevious = true;
+			}
+			AddLookAtAndShake(pov, (float)frame);
+		}
+		bakedTrack->AddFrame(pov);
 	}
-	gameApplier->SetPOV(pov.location, pov.rotation, pov.FOV);
-	//flyCam.SetPOV(pov.ToPOV());
+	bakedRevision = evaluationRevision;
+	warnedOutdatedBake = false;
+	cvarManager->log("Baked " + to_string(bakedTrack->GetFrameCount()) + " frames (" + to_string(bakedTrack->GetStartFrame()) + " - " + to_string(bakedTrack->GetEndFrame()) + ")");
+	return true;
+}
+
+bool DollyCam::SaveBakedTrack(string filename)
+{
+	if (!bakedTrack)
+		return false;
+	return bakedTrack->SaveToFile(filename);
+}
+
+bool DollyCam::LoadBakedTrack(string filename)
+{
+	auto track = std::make_shared<BakedTrack>();
+	if (!track->LoadFromFile(filename))
+		return false;
+	bakedTrack = track;
+	bakedRevision = evaluationRevision;
+	warnedOutdatedBake = false;
+	return true;
+}
+
+void DollyCam::SetPlayBakedTrack(bool playBaked)
+{
+	playBakedTrack = playBaked;
+}
+
+bool DollyCam::SetTimeRemapKey(int frame, float pathFrame)
+{
+	if (!timeRemap.SetKey(frame, pathFrame))
+		return false;
+	evaluationRevision++;
+	return true;
+}
+
+bool DollyCam::RemoveTimeRemapKey(int frame)
+{
+	if (!timeRemap.RemoveKey(frame))
+		return false;
+	evaluationRevision++;
+	return true;
+}
+
+void DollyCam::ClearTimeRemap()
+{
+	timeRemap.Clear();
+	evaluationRevision++;
+}
+
+const TimeRemap& DollyCam::GetTimeRemap()
+{
+	return timeRemap;
+}
+
+void DollyCam::SetShake(const ShakeSettings& settings)
+{
+	shake.SetSettings(settings);
+	evaluationRevision++;
+}
+
+bool DollyCam::IsPlayingBakedTrack()
+{
+	return playBakedTrack && bakedTrack;
 }
 
 void DollyCam::Reset()
@@ -181,6 +415,240 @@ void DollyCam::Reset()
 	this->RefreshInterpDataRotation();
 }
 
+bool DollyCam::IsRecording()
+{
+	return isRecording;
+}
+
+void DollyCam::StartRecording(PathTolerance tolerance)
+{
+	if (isRecording)
+		return;
+	recorder.Start(tolerance);
+	isRecording = true;
+	cvarManager->log("Dollycam recording started");
+}
+
+void DollyCam::RecordTick()
+{
+	if (!isRecording)
+		return;
+	CameraSnapshot sample = TakeSnapshot(false);
+	if (sample.FOV < 1) //Invalid camerastate
+		return;
+	recorder.AddSample(sample);
+}
+
+bool DollyCam::IsRecordingTarget()
+{
+	return isRecordingTarget;
+}
+
+void DollyCam::StartTargetRecording()
+{
+	if (isRecordingTarget)
+		return;
+	targetTrack.Clear();
+	isRecordingTarget = true;
+	cvarManager->log("Dollycam target recording started");
+}
+
+void DollyCam::RecordTargetTick()
+{
+	if (!isRecordingTarget || !gameWrapper->IsInReplay())
+		return;
+	ReplayServerWrapper sw = gameWrapper->GetGameEventAsReplay();
+	if (sw.IsNull())
+		return;
+	BallWrapper ball = sw.GetBall();
+	if (ball.IsNull())
+		return;
+	targetTrack.RecordFrame(sw.GetCurrentReplayFrame(), ball.GetLocation());
+}
+
+void DollyCam::StopTargetRecording()
+{
+	if (!isRecordingTarget)
+		return;
+	isRecordingTarget = false;
+	evaluationRevision++;
+	cvarManager->log("Dollycam target recording stopped, recorded frames " + to_string(targetTrack.GetStartFrame()) + " - " + to_string(targetTrack.GetEndFrame()));
+}
+
+bool DollyCam::SaveTargetTrack(string filename)
+{
+	if (targetTrack.IsEmpty())
+		return false;
+	return targetTrack.SaveToFile(filename);
+}
+
+bool DollyCam::LoadTargetTrack(string filename)
+{
+	TargetTrack track;
+	if (!track.LoadFromFile(filename))
+		return false;
+	targetTrack = track;
+	evaluationRevision++;
+	return true;
+}
+
+void DollyCam::SetLookAtTarget(bool lookAt)
+{
+	lookAtTarget = lookAt;
+	evaluationRevision++;
+}
+
+bool DollyCam::LoadCollisionMesh(string filename)
+{
+	auto start = std::chrono::steady_clock::now();
+	CollisionMesh mesh;
+	if (!mesh.LoadFromFile(filename))
+		return false;
+	collisionMesh = mesh;
+	evaluationRevision++;
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	cvarManager->log("Loaded " + to_string(collisionMesh.GetTriangleCount()) + " triangles into " + to_string(collisionMesh.GetNodeCount()) + " nodes in " + to_string_with_precision(milliseconds, 2) + "ms");
+	UpdateRenderPath();
+	return true;
+}
+
+void DollyCam::SetCollisionAvoidance(bool enabled, float radius)
+{
+	avoidCollisions = enabled;
+	collisionRadius = (std::max)(0.f, radius);
+	lastCameraFrame = -1;
+	collidingFrames.clear();
+	evaluationRevision++;
+	UpdateRenderPath();
+}
+
+void DollyCam::CheckCollisions()
+{
+	if (collisionMesh.IsEmpty())
+	{
+		cvarManager->log("No collision mesh loaded, use dolly_collision_load filename");
+		return;
+	}
+	if (!currentRenderPath || currentRenderPath->empty())
+	{
+		cvarManager->log("No render path to check");
+		return;
+	}
+
+	std::vector<int> frames = collidingFrames;
+	double milliseconds = collisionMilliseconds;
+	if (!avoidCollisions)
+	{
+		//The render path hasn't been corrected, check a copy so it stays as is
+		auto start = std::chrono::steady_clock::now();
+		savetype path = *currentRenderPath;
+		frames = PushOutPath(path);
+		milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+	if (frames.empty())
+	{
+		cvarManager->log("No collisions in " + to_string(currentRenderPath->size()) + " frames (" + to_string_with_precision(milliseconds, 2) + "ms)");
+		return;
+	}
+
+	string ranges;
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		size_t last = i;
+		while (last + 1 < frames.size() && frames[last + 1] == frames[last] + 1)
+			last++;
+		ranges += (ranges.empty() ? "" : ", ") + to_string(frames[i]) + (last > i ? "-" + to_string(frames[last]) : "");
+		i = last;
+	}
+	cvarManager->log(to_string(frames.size()) + " frames " + (avoidCollisions ? "were pushed out of" : "go through") + " the collision mesh (" + to_string_with_precision(milliseconds, 2) + "ms): " + ranges);
+}
+
+int DollyCam::StopRecording()
+{
+	if (!isRecording)
+		return 0;
+	isRecording = false;
+	savetype reduced = recorder.Finish();
+	cvarManager->log("Dollycam recording stopped, reduced " + to_string(recorder.GetSamplesRecorded()) + " samples to " + to_string(reduced.size()) + " snapshots");
+	if (reduced.empty())
+		return 0;
+
+	*currentPath = reduced;
+	this->RefreshInterpData();
+	this->RefreshInterpDataRotation();
+	return reduced.size();
+}
+
+PlaybackStrategies DollyCam::GetPlaybackStrategies()
+{
+	PlaybackStrategies playback;
+	int locationMode = cvarManager->getCvar("dolly_interpmode_location").getIntValue();
+	int rotationMode = cvarManager->getCvar("dolly_interpmode_rotation").getIntValue();
+	playback.location = [this, locationMode](std::shared_ptr<savetype> path) { return CreateInterpStrategy(locationMode, path); };
+	if (rotationMode != locationMode)
+		playback.rotation = [this, rotationMode](std::shared_ptr<savetype> path) { return CreateInterpStrategy(rotationMode, path); };
+	if (gameWrapper->IsInReplay())
+		replayTickRate = 1.f / (float)gameWrapper->GetGameEventAsReplay().GetReplayFPS();
+	playback.replayTickRate = replayTickRate;
+	return playback;
+}
+
+int DollyCam::ReducePath(PathTolerance tolerance)
+{
+	savetype reduced;
+	bool withinTolerance;
+	try
+	{
+		PathReducer reducer(tolerance, GetPlaybackStrategies());
+		reduced = reducer.Reduce(*currentPath);
+		withinTolerance = reducer.IsWithinTolerance();
+	}
+	catch (const std::runtime_error& e)
+	{
+		cvarManager->log("Failed to reduce path: " + string(e.what()));
+		return currentPath->size();
+	}
+	cvarManager->log("Reduced path from " + to_string(currentPath->size()) + " to " + to_string(reduced.size()) + " snapshots");
+	if (!withinTolerance)
+		cvarManager->log("Parts of the reduced path are still out of tolerance");
+
+	*currentPath = reduced;
+	this->RefreshInterpData();
+	this->RefreshInterpDataRotation();
+	return reduced.size();
+}
+
+int DollyCam::OptimizePath(PathTolerance tolerance, std::vector<int> stopFrames)
+{
+	savetype optimized;
+	try
+	{
+		PathOptimizer optimizer(tolerance, GetPlaybackStrategies());
+		optimized = optimizer.Optimize(*currentPath, GetFrameTimeTable(), stopFrames);
+		if (!optimizer.IsWithinTolerance())
+		{
+			cvarManager->log("Failed to smooth path: the smoothed path can't be played back within tolerance, the path was left as is");
+			return currentPath->size();
+		}
+		if (optimized.size() > currentPath->size())
+		{
+			cvarManager->log("Failed to smooth path: the smoothed path needs " + to_string(optimized.size()) + " snapshots, more than the " + to_string(currentPath->size()) + " it has now, the path was left as is");
+			return currentPath->size();
+		}
+	}
+	catch (const std::runtime_error& e)
+	{
+		cvarManager->log("Failed to smooth path: " + string(e.what()));
+		return currentPath->size();
+	}
+	cvarManager->log("Smoothed path from " + to_string(currentPath->size()) + " to " + to_string(optimized.size()) + " snapshots");
+
+	*currentPath = optimized;
+	this->RefreshInterpData();
+	this->RefreshInterpDataRotation();
+	return optimized.size();
+}
+
 void DollyCam::InsertSnapshot(CameraSnapshot snapshot)
 {
 	this->currentPath->insert_or_assign(snapshot.frame, snapshot);
@@ -265,107 +733,68 @@ void DollyCam::SetRenderFrames(bool _renderFrames)
 {
 	this->renderFrames = _renderFrames;
 }
-inline float Dot(Rotator rot, Vector line)
+
+void DollyCam::SetRenderLOD(float pixelError)
+{
+	pathRenderer.SetLODPixelError(pixelError);
+}
+
+void DollyCam::SetMotionOverlay(int channel)
 {
-	Vector fov = RotatorToVector(rot);
-	return Vector::dot(fov, line);
+	pathRenderer.SetMotionOverlay(channel);
+}
+
+const PathMotion& DollyCam::GetRenderPathMotion()
+{
+	return renderPathMotion;
 }
 void DollyCam::Render(CanvasWrapper cw)
 {
-	if (!renderPath || !currentRenderPath || currentRenderPath->size() < 2)
+	if (!renderPath || !currentRenderPath || pathRenderer.GetPointCount() < 2)
 		return;
+	ScopedTimer timer(PROFILE_RENDER);
+	TRACE_SCOPE("Render");
 
 	ReplayServerWrapper sw = gameWrapper->GetGameEventAsReplay();
 	CameraWrapper cam = gameWrapper->GetCamera();
-	auto location = cam.GetLocation();
-	auto rotation = cam.GetRotation();
+	CameraView view;
+	view.location = cam.GetLocation();
+	view.rotation = cam.GetRotation();
+	view.FOV = cam.GetFOV();
+	view.canvasSize = cw.GetSize();
 	int currentFrame = sw.GetCurrentReplayFrame();
 
-	Vector2 prevLine = cw.Project(currentRenderPath->begin()->second.location);
-	Vector2 canvasSize = cw.GetSize();
-
-	int colTest = 255;
-	for (auto it = (++currentRenderPath->begin()); it != currentRenderPath->end(); ++it)
-	{
-		Vector2 line = cw.Project(it->second.location);
-
-		if (it->first - 2 < currentFrame && it->first + 2 > currentFrame)
-		{
-			cw.SetColor(255, 0, 0, 255);
-		}
-		else
-		{
-			cw.SetColor(0, 0, colTest, 255);
-			colTest = colTest == 0 ? 255 : 255;
-		}
-
-		line.X = max(0, line.X);
-		line.X = min(line.X, canvasSize.X);
-		line.Y = max(0, line.Y);
-		line.Y = min(line.Y, canvasSize.Y);
-		bool inFrustum = false;
-		Vector cam_to_line = (it->second.location - location);
-		cam_to_line.normalize();
-		float cam_dot_line = Dot(rotation, cam_to_line);
-		if (cam_dot_line > 0) inFrustum = true;
-		if (inFrustum) {
-			if (!(((line.X < .1 || line.X >= canvasSize.X - .5) && (line.Y < .1 || line.Y >= canvasSize.Y - .5)) || ((prevLine.X < .1 || prevLine.X >= canvasSize.X - .5) && (prevLine.Y < .1 || prevLine.Y >= canvasSize.Y - .5))))
-			{
-				cw.DrawLine(prevLine, line);
-				cw.DrawLine(prevLine.minus({ 1,1 }), line.minus({ 1,1 })); //make lines thicker
-				cw.DrawLine(prevLine.minus({ -1,-1 }), line.minus({ -1,-1 }));
-				if (renderFrames) {
-					cw.SetColor(0, 0, 0, 255);
-					cw.SetPosition(line);
-					cw.DrawString(to_string(it->first));
-				}
-			}
-		}
-		prevLine = line;
-	}
-
-	int index = 1;
-	for (auto it = currentPath->begin(); it != currentPath->end(); it++)
-	{
-		auto boxLoc = cw.Project(it->second.location);
-		bool inFrustum = false;
-		Vector cam_to_box = (it->second.location - location);
-		cam_to_box.normalize();
-		float cam_dot_line = Dot(rotation, cam_to_box);
-		if (cam_dot_line > 0) inFrustum = true;
-		if (inFrustum) {
-			cw.SetColor(255, 0, 0, 255);
-			if (boxLoc.X >= 0 && boxLoc.X <= canvasSize.X && boxLoc.Y >= 0 && boxLoc.Y <= canvasSize.Y) {
-				boxLoc.X -= 5;
-				boxLoc.Y -= 5;
-				cw.SetPosition(boxLoc);
-				auto tmp = Vector2();
-				tmp.X = 10; tmp.Y = 10;
-				cw.FillBox(tmp);
-				cw.SetColor(255, 255, 255, 255);
-				cw.DrawString("(" + to_string(index) + ")" + " (ID:" + to_string(it->first) + ", w:" + to_string_with_precision(it->second.weight, 2) + ")");
-			}
-		}
-		index++;
-	}
+	//The highlight follows the part of the path that is being played
+	pathRenderer.Render(cw, view, (int)floor(timeRemap.Map((float)currentFrame)), renderFrames);
 }
 
 void DollyCam::RefreshInterpData()
 {
+	TRACE_SCOPE("RefreshInterpData");
 	CVarWrapper interpMode = cvarManager->getCvar("dolly_interpmode_location");
-	locationInterpStrategy = CreateInterpStrategy(interpMode.getIntValue());
+	{
+		ScopedTimer timer(PROFILE_STRATEGY_REBUILD);
+		locationInterpStrategy = CreateInterpStrategy(interpMode.getIntValue());
+	}
+	pathRevision++;
+	evaluationRevision++;
 	UpdateRenderPath();
 	CheckIfSameInterp();
 }
 
 void DollyCam::RefreshInterpDataRotation()
 {
+	TRACE_SCOPE("RefreshInterpDataRotation");
 	CVarWrapper interpMode = cvarManager->getCvar("dolly_interpmode_rotation");
-	rotationInterpStrategy = CreateInterpStrategy(interpMode.getIntValue());
+	{
+		ScopedTimer timer(PROFILE_STRATEGY_REBUILD);
+		rotationInterpStrategy = CreateInterpStrategy(interpMode.getIntValue());
+	}
 	if (locationInterpStrategy->GetName().compare((rotationInterpStrategy)->GetName()) == 0)
 	{
 		rotationInterpStrategy = locationInterpStrategy;
 	}
+	evaluationRevision++;
 	CheckIfSameInterp();
 }
 
@@ -382,64 +811,205 @@ string DollyCam::GetInterpolationMethod(bool locationInterp)
 
 shared_ptr<InterpStrategy> DollyCam::CreateInterpStrategy(int interpStrategy)
 {
+	return CreateInterpStrategy(interpStrategy, currentPath);
+}
 
+shared_ptr<InterpStrategy> DollyCam::CreateInterpStrategy(int interpStrategy, std::shared_ptr<savetype> path)
+{
 	int chaikinDegree = cvarManager->getCvar("dolly_chaikin_degree").getIntValue();
-	switch (interpStrategy)
-	{
-	case 0:
-		return std::make_shared<LinearInterpStrategy>(LinearInterpStrategy(currentPath, chaikinDegree));
-		break;
-	case 1:
-		return std::make_shared<NBezierInterpStrategy>(NBezierInterpStrategy(currentPath, chaikinDegree));
-		break;
-	case 2:
-		return std::make_shared<CosineInterpStrategy>(CosineInterpStrategy(currentPath));
-		break;
-	case 3:
-		std::make_shared<LinearInterpStrategy>(LinearInterpStrategy(currentPath, chaikinDegree));
-		//return std::make_shared<HermiteInterpStrategy>(HermiteInterpStrategy(currentPath));
-		break;
-	case 4:
-		return std::make_shared<CatmullRomInterpStrategy>(CatmullRomInterpStrategy(currentPath, chaikinDegree));
-		break;
-	case 5:
-		auto tmp = std::make_shared<SplineInterpStrategy>(SplineInterpStrategy(currentPath, chaikinDegree));
-		tmp->cvarManager = cvarManager;
-		return tmp;
-	}
+	int splineAccuracy = cvarManager->getCvar("dolly_spline_acc").getIntValue();
+	auto strategy = ::CreateInterpStrategy(interpStrategy, path, chaikinDegree, splineAccuracy);
+	if (strategy)
+		return strategy;
 
 	cvarManager->log("Interpstrategy not found!!! Defaulting to linear interp.");
-	return std::make_shared<LinearInterpStrategy>(LinearInterpStrategy(currentPath, chaikinDegree));
+	return std::make_shared<LinearInterpStrategy>(LinearInterpStrategy(path, chaikinDegree));
 }
 
-void DollyCam::SaveToFile(string filename)
+void DollyCam::BuildTrack(PathTrack& track)
 {
-	std::map<string, CameraSnapshot> pathCopy;
-	for (auto& i : *currentPath)
+	ScopedTimer timer(PROFILE_STRATEGY_REBUILD);
+	int locationMode = cvarManager->getCvar("dolly_interpmode_location").getIntValue();
+	int rotationMode = cvarManager->getCvar("dolly_interpmode_rotation").getIntValue();
+	track.locationStrategy = CreateInterpStrategy(locationMode, track.path);
+	track.rotationStrategy = rotationMode == locationMode ? track.locationStrategy : CreateInterpStrategy(rotationMode, track.path);
+	track.frameTimes.Build(*track.path, replayTickRate);
+}
+
+void DollyCam::SortTracks()
+{
+	tracksByStart.clear();
+	for (const auto& item : tracks)
+		tracksByStart.push_back(&item.second);
+	std::sort(tracksByStart.begin(), tracksByStart.end(), [](const PathTrack* a, const PathTrack* b) { return a->GetStartFrame() < b->GetStartFrame(); });
+	lastPlayedIndex = -1;
+
+	for (auto& blend : blends)
 	{
-		pathCopy.insert_or_assign(to_string(i.first), i.second);
+		auto from = tracks.find(blend.from);
+		auto to = tracks.find(blend.to);
+		blend.fromTrack = from == tracks.end() ? nullptr : &from->second;
+		blend.toTrack = to == tracks.end() ? nullptr : &to->second;
 	}
-	json j = pathCopy;
-	ofstream myfile;
-	myfile.open(filename);
-	myfile << j.dump(4);
-	myfile.close();
 }
 
-void DollyCam::LoadFromFile(string filename)
+const TrackBlend* DollyCam::FindBlend(int frame)
+{
+	for (const auto& blend : blends)
+	{
+		if (blend.Contains(frame))
+			return &blend;
+	}
+	return nullptr;
+}
+
+const PathTrack* DollyCam::FindTrack(int frame)
 {
-	std::ifstream i(filename);
-	json j;
-	i >> j;
-	currentPath->clear();
-	auto v8 = j.get<std::map<string, CameraSnapshot>>();
-	for (auto& i : v8)
+	//Playback usually stays on the same track for many ticks, the cached one still wins as long as no track that started after it covers the frame
+	if (lastPlayedIndex >= 0 && tracksByStart[lastPlayedIndex]->Contains(frame))
 	{
-		string first = i.first;
-		int intVal = get_safe_int(first);
-		CameraSnapshot value = i.second;
-		currentPath->insert_or_assign(intVal, value);
+		size_t later = lastPlayedIndex + 1;
+		while (later < tracksByStart.size() && tracksByStart[later]->GetStartFrame() <= frame && !tracksByStart[later]->Contains(frame))
+			later++;
+		if (later == tracksByStart.size() || tracksByStart[later]->GetStartFrame() > frame)
+			return tracksByStart[lastPlayedIndex];
 	}
+	auto it = std::upper_bound(tracksByStart.begin(), tracksByStart.end(), frame, [](int frame, const PathTrack* track) { return frame < track->GetStartFrame(); });
+	//With overlapping tracks the one that started last wins
+	while (it != tracksByStart.begin())
+	{
+		--it;
+		if ((*it)->Contains(frame))
+		{
+			lastPlayedIndex = (int)(it - tracksByStart.begin());
+			return *it;
+		}
+	}
+	return nullptr;
+}
+
+bool DollyCam::StoreTrack(string name)
+{
+	if (currentPath->size() < 2)
+		return false;
+	if (gameWrapper->IsInReplay())
+		replayTickRate = 1.f / (float)gameWrapper->GetGameEventAsReplay().GetReplayFPS();
+	PathTrack track;
+	track.name = name;
+	track.path = std::make_shared<savetype>(*currentPath);
+	BuildTrack(track);
+	tracks[name] = track;
+	SortTracks();
+	return true;
+}
+
+bool DollyCam::EditTrack(string name)
+{
+	auto it = tracks.find(name);
+	if (it == tracks.end())
+		return false;
+	*currentPath = *it->second.path;
+	this->RefreshInterpData();
+	this->RefreshInterpDataRotation();
+	return true;
+}
+
+bool DollyCam::RemoveTrack(string name)
+{
+	if (tracks.erase(name) == 0)
+		return false;
+	SortTracks();
+	return true;
+}
+
+const std::map<std::string, PathTrack>& DollyCam::GetTracks()
+{
+	return tracks;
+}
+
+void DollyCam::RebuildTracks()
+{
+	for (auto& item : tracks)
+		BuildTrack(item.second);
+	library.ResetStrategies();
+}
+
+void DollyCam::SetPlayTracks(bool play)
+{
+	playTracks = play;
+}
+
+bool DollyCam::AddBlend(string from, string to, int startFrame, int endFrame)
+{
+	if (endFrame <= startFrame)
+		return false;
+	TrackBlend blend;
+	blend.from = from;
+	blend.to = to;
+	blend.startFrame = startFrame;
+	blend.endFrame = endFrame;
+	blends.push_back(blend);
+	SortTracks();
+	return true;
+}
+
+void DollyCam::ClearBlends()
+{
+	blends.clear();
+}
+
+const std::vector<TrackBlend>& DollyCam::GetBlends()
+{
+	return blends;
+}
+
+size_t DollyCam::BuildLibraryTrack(PathTrack& track)
+{
+	if (gameWrapper->IsInReplay())
+		replayTickRate = 1.f / (float)gameWrapper->GetGameEventAsReplay().GetReplayFPS();
+	BuildTrack(track);
+	//Every strategy keeps its own copy of the path, each chaikin pass roughly doubles it
+	int chaikinDegree = (std::min)(cvarManager->getCvar("dolly_chaikin_degree").getIntValue(), 20);
+	size_t snapshotBytes = sizeof(savetype::value_type) + 4 * sizeof(void*);
+	size_t strategyBytes = (track.path->size() << chaikinDegree) * snapshotBytes;
+	return track.rotationStrategy == track.locationStrategy ? strategyBytes : strategyBytes * 2;
+}
+
+size_t DollyCam::ScanLibrary(string directory)
+{
+	return library.Scan(directory);
+}
+
+PathLibrary& DollyCam::GetLibrary()
+{
+	return library;
+}
+
+bool DollyCam::LoadFromLibrary(string name)
+{
+	auto track = library.Get(name);
+	if (!track)
+		return false;
+	*currentPath = *track->path;
+	locationInterpStrategy = track->locationStrategy;
+	rotationInterpStrategy = track->rotationStrategy;
+	pathRevision++;
+	evaluationRevision++;
+	UpdateRenderPath();
+	CheckIfSameInterp();
+	return true;
+}
+
+void DollyCam::SaveToFile(string filename)
+{
+	TRACE_SCOPE("SaveToFile");
+	SavePathToFile(filename, *currentPath);
+}
+
+void DollyCam::LoadFromFile(string filename)
+{
+	TRACE_SCOPE("LoadFromFile");
+	*currentPath = LoadPathFromFile(filename);
 
 	this->RefreshInterpData();
 	this->RefreshInterpDataRotation();
@@ -450,7 +1020,15 @@ std::shared_ptr<savetype> DollyCam::GetCurrentPath()
 	return currentPath;
 }
 
+unsigned int DollyCam::GetPathRevision()
+{
+	return pathRevision;
+}
+
 void DollyCam::SetCurrentPath(std::shared_ptr<savetype> newPath)
 {
 	currentPath = newPath;
+	//Rebuilding bumps the revisions and keeps the strategies on the new path
+	RefreshInterpData();
+	RefreshInterpDataRotation();
 }
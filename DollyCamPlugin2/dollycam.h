@@ -5,6 +5,17 @@
 #include "bakkesmod\plugin\bakkesmodplugin.h"
 #include "gameapplier.h"
 #include "models.h"
+#include "pathrecorder.h"
+#include "pathreducer.h"
+#include "bakedtrack.h"
+#include "pathrenderer.h"
+#include "pathtiming.h"
+#include "pathtrack.h"
+#include "pathblend.h"
+#include "camerashake.h"
+#include "targettrack.h"
+#include "pathlibrary.h"
+#include "collisionmesh.h"
 #include "interpstrategies/interpstrategy.h"
 #include "bakkesmod\wrappers\includes.h"
 
@@ -19,11 +30,71 @@ private:
 	std::shared_ptr<InterpStrategy> rotationInterpStrategy;
 
 	std::shared_ptr<savetype> currentRenderPath;
+	PathMotion renderPathMotion;
+	PathRenderer pathRenderer;
+	std::shared_ptr<BakedTrack> bakedTrack;
+	bool playBakedTrack = false;
+	//Changes whenever the path, its strategies, the time remap or the look-at, shake and collision layers change,
+	//a bake from an older revision is out of date
+	unsigned int evaluationRevision = 0;
+	unsigned int bakedRevision = 0;
+	bool warnedOutdatedBake = false;
 	bool usesSameInterp = false;
 	bool isActive = false;
 	bool renderPath = false;
 	bool renderFrames = false;
+	bool isRecording = false;
+	unsigned int pathRevision = 0;
+	PathRecorder recorder;
+	FrameTimeTable frameTimeTable;
+	unsigned int frameTimesRevision = 0;
+	float replayTickRate = 1.f / 30.f;
+	int lastAppliedFrame = -1;
+	float frameStartSeconds = 0;
+	void UpdateFrameTimes();
+	float GetFrameFraction(float secondsElapsed, int currentFrame);
+	CameraShake shake;
+	TargetTrack targetTrack;
+	bool lookAtTarget = false;
+	bool isRecordingTarget = false;
+	CollisionMesh collisionMesh;
+	bool avoidCollisions = false;
+	float collisionRadius = 20.f;
+	//Frames of the render path that were pushed out of the collision mesh when it was last built
+	std::vector<int> collidingFrames;
+	//How long pushing the render path out took when it was last built
+	double collisionMilliseconds = 0;
+	Vector lastCameraLocation;
+	float lastCameraFrame = -1;
+	//Pushes every location of the path out of the collision mesh, returns the frames that had to be moved
+	std::vector<int> PushOutPath(savetype& path);
+	//Keeps the camera out of the collision mesh, points it at the target when look-at is enabled,
+	//adds the shake for the given fractional frame and sends the camera state to the game
+	void SetPOV(NewPOV pov, float frame);
+	void AddLookAtAndShake(NewPOV& pov, float frame);
+	//Named tracks, and the same tracks sorted by start frame for lookups during playback
+	std::map<std::string, PathTrack> tracks;
+	std::vector<const PathTrack*> tracksByStart;
+	//Index into tracksByStart of the track found last, -1 when there is none
+	int lastPlayedIndex = -1;
+	bool playTracks = false;
+	std::vector<TrackBlend> blends;
+	void BuildTrack(PathTrack& track);
+	PathLibrary library;
+	size_t BuildLibraryTrack(PathTrack& track);
+	//Also points the blends at their tracks
+	void SortTracks();
+	const PathTrack* FindTrack(int frame);
+	const TrackBlend* FindBlend(int frame);
+	//Strategies playback would build for a path with the current interp settings
+	PlaybackStrategies GetPlaybackStrategies();
+	//Rebuilds the table if the path changed since it was built
+	const FrameTimeTable& GetFrameTimeTable();
 	void UpdateRenderPath();
+	NewPOV EvaluatePOV(float time, int frame);
+	//Evaluates the current path at a fractional replay frame, going through the time remap
+	NewPOV EvaluateFrame(float frame);
+	TimeRemap timeRemap;
 	void CheckIfSameInterp();
 
 public:
@@ -37,6 +108,43 @@ public:
 	void Deactivate();
 	void Apply();
 	void Reset();
+	//Evaluates the current strategies for every frame of the path, with the look-at, shake and collision layers applied
+	bool Bake();
+	bool SaveBakedTrack(string filename);
+	bool LoadBakedTrack(string filename);
+	void SetPlayBakedTrack(bool playBaked);
+	void SetShake(const ShakeSettings& settings);
+	//Plays path frame pathFrame at replay frame frame, returns false if the path would run backwards
+	bool SetTimeRemapKey(int frame, float pathFrame);
+	bool RemoveTimeRemapKey(int frame);
+	void ClearTimeRemap();
+	const TimeRemap& GetTimeRemap();
+	bool IsPlayingBakedTrack();
+	bool IsRecording();
+	void StartRecording(PathTolerance tolerance);
+	void RecordTick();
+	//Stops recording and replaces the current path with the reduced recording, returns the amount of keyframes
+	int StopRecording();
+	bool IsRecordingTarget();
+	//Records the ball location every tick into a new target track
+	void StartTargetRecording();
+	void RecordTargetTick();
+	void StopTargetRecording();
+	bool SaveTargetTrack(string filename);
+	bool LoadTargetTrack(string filename);
+	//When enabled the rotation of the path is replaced by one looking at the target track
+	void SetLookAtTarget(bool lookAt);
+	//Loads the arena geometry from a .obj file and builds its bounding volume hierarchy
+	bool LoadCollisionMesh(string filename);
+	//When enabled the render path and playback are kept radius away from the collision mesh
+	void SetCollisionAvoidance(bool enabled, float radius);
+	//Logs the frames of the render path that go through the collision mesh
+	void CheckCollisions();
+	//Replaces the current path with a spline fitted version using as few snapshots as the tolerance allows, returns the amount of snapshots
+	int ReducePath(PathTolerance tolerance);
+	//Replaces the path with its minimum jerk curve, velocity is zero at the snapshots on stopFrames.
+	//The path is left as is if the curve can't be played back within the tolerance or needs more snapshots than the path has
+	int OptimizePath(PathTolerance tolerance, std::vector<int> stopFrames);
 	void InsertSnapshot(CameraSnapshot snapshot);
 	bool IsFrameUsed(int frame);
 	CameraSnapshot GetSnapshot(int frame);
@@ -45,14 +153,40 @@ public:
 	vector<int> GetUsedFrames();
 	void SetRenderPath(bool render);
 	void SetRenderFrames(bool renderFrames);
+	void SetRenderLOD(float pixelError);
+	//Colors the rendered path by a MotionChannel, anything else turns the overlay off
+	void SetMotionOverlay(int channel);
+	const PathMotion& GetRenderPathMotion();
 	void Render(CanvasWrapper cw);
 	void RefreshInterpData();
 	void RefreshInterpDataRotation();
 	string GetInterpolationMethod(bool locationInterp);
 	shared_ptr<InterpStrategy> CreateInterpStrategy(int interpStrategy);
+	shared_ptr<InterpStrategy> CreateInterpStrategy(int interpStrategy, std::shared_ptr<savetype> path);
+	//Copies the current path into a named track, replacing any track with the same name
+	bool StoreTrack(string name);
+	//Copies the track into the current path so it can be edited
+	bool EditTrack(string name);
+	bool RemoveTrack(string name);
+	const std::map<std::string, PathTrack>& GetTracks();
+	//Rebuilds the strategies of every track, needed when interp settings change
+	void RebuildTracks();
+	//When enabled, playback uses whichever track covers the current frame instead of the current path
+	void SetPlayTracks(bool play);
+	//Cross-fades from one track to another between the given frames during track playback
+	bool AddBlend(string from, string to, int startFrame, int endFrame);
+	void ClearBlends();
+	const std::vector<TrackBlend>& GetBlends();
+	//Indexes the path files in a directory, returns the amount of paths found
+	size_t ScanLibrary(string directory);
+	PathLibrary& GetLibrary();
+	//Makes a copy of a library path the current path, reusing the cached strategies
+	bool LoadFromLibrary(string name);
 	void SaveToFile(string filename);
 	void LoadFromFile(string filename);
 	std::shared_ptr<savetype> GetCurrentPath();
+	//Changes every time the current path is modified
+	unsigned int GetPathRevision();
 	void SetCurrentPath(std::shared_ptr<savetype> newPath);
 };
 
@@ -6,6 +6,8 @@
 #include "utils\parser.h"
 #include "serialization.h"
 #include "utils/io.h"
+#include "batchsimulator.h"
+#include "goldenharness.h"
 
 using namespace std::placeholders;
 
@@ -47,16 +49,77 @@ void DollyCamPlugin::onLoad()
 	cvarManager->registerCvar("dolly_render", "1", "Render the current camera path", true, true, 0, true, 1).bindTo(renderCameraPath);
 
 	cvarManager->registerCvar("dolly_render_frame", "1", "Render frame numbers on the path", true, true, 0, true, 1).addOnValueChanged(bind(&DollyCamPlugin::OnRenderFramesChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_render_lod", "1", "Allowed screen space error in pixels when simplifying the rendered path (0 = draw every frame)", true, true, 0, true, 50)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnRenderLODChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_render_motion", "0", "Colors the rendered path by its motion (0 = off, 1 = speed, 2 = angular speed, 3 = acceleration)", true, true, 0, true, 3)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnMotionOverlayChanged, this, _1, _2));
 
 	cvarManager->registerNotifier("dolly_path_clear", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Clears the current dollycam path", PERMISSION_ALL);
 	cvarManager->registerNotifier("dolly_snapshot_take", bind(&DollyCamPlugin::OnReplayCommand, this, _1), "Saves the current camera view as snapshot", PERMISSION_REPLAY);
 	cvarManager->registerNotifier("dolly_activate", bind(&DollyCamPlugin::OnReplayCommand, this, _1), "Activates the dollycam (Plays current path) ", PERMISSION_REPLAY);
 	cvarManager->registerNotifier("dolly_deactivate", bind(&DollyCamPlugin::OnReplayCommand, this, _1), "Deactivates the dollycam", PERMISSION_REPLAY);
+	cvarManager->registerNotifier("dolly_record_start", bind(&DollyCamPlugin::OnReplayCommand, this, _1), "Records the flycam every tick and reduces it to a path when stopped", PERMISSION_REPLAY);
+	cvarManager->registerNotifier("dolly_record_stop", bind(&DollyCamPlugin::OnReplayCommand, this, _1), "Stops recording and replaces the current path with the recording", PERMISSION_REPLAY);
+	cvarManager->registerNotifier("dolly_target_record_start", bind(&DollyCamPlugin::OnReplayCommand, this, _1), "Records the ball location every frame as the target for dolly_lookat, play the replay over the shot to record it", PERMISSION_REPLAY);
+	cvarManager->registerNotifier("dolly_target_record_stop", bind(&DollyCamPlugin::OnReplayCommand, this, _1), "Stops recording the target track", PERMISSION_REPLAY);
 	cvarManager->registerNotifier("dolly_replayinfo", bind(&DollyCamPlugin::OnInReplayCommand, this, _1), "Prints current replay information to the console", PERMISSION_REPLAY);
 
 	cvarManager->registerNotifier("dolly_path_save", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Saves the current dolly path to a file. Usage: dolly_path_save filename", PERMISSION_ALL);
 	cvarManager->registerNotifier("dolly_path_load", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Loads the current dolly path from a file. Usage: dolly_path_load filename", PERMISSION_ALL);
 
+	cvarManager->registerNotifier("dolly_bake", bind(&DollyCamPlugin::OnInReplayCommand, this, _1), "Evaluates the current path for every frame and plays it back from the baked track. Usage: dolly_bake [filename]", PERMISSION_REPLAY);
+	cvarManager->registerNotifier("dolly_bake_load", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Loads a baked track from a file and plays it back. Usage: dolly_bake_load filename", PERMISSION_ALL);
+	cvarManager->registerCvar("dolly_bake_playback", "0", "Play back the baked track instead of evaluating the path every tick", true, true, 0, true, 1)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnBakePlaybackChanged, this, _1, _2));
+	cvarManager->registerNotifier("dolly_batch_simulate", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Simulates playback of saved paths with the current interp settings and writes a camera track per path. Usage: dolly_batch_simulate outputdirectory filename [filename ...]", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_golden_record", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Stores reference tracks of saved paths for every interp mode and chaikin degree. Usage: dolly_golden_record directory filename [filename ...]", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_golden_compare", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Compares the current interp strategies against the stored reference tracks. Usage: dolly_golden_compare directory filename [filename ...]", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_track_store", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Stores the current path as a named track of the timeline. Usage: dolly_track_store name", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_track_edit", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Copies a track into the current path for editing, store it again to apply the changes. Usage: dolly_track_edit name", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_track_remove", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Removes a track from the timeline. Usage: dolly_track_remove name", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_track_list", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Lists the tracks of the timeline and the frames they cover", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_track_blend", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Cross-fades from one track to another over the given frames during track playback. Usage: dolly_track_blend from to startframe endframe", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_track_blend_clear", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Removes every track blend", PERMISSION_ALL);
+	cvarManager->registerCvar("dolly_track_playback", "0", "Play back the stored tracks, switching to whichever track covers the current frame", true, true, 0, true, 1)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnTrackPlaybackChanged, this, _1, _2));
+	cvarManager->registerNotifier("dolly_library_scan", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Indexes every path file in a directory for dolly_library_load. Usage: dolly_library_scan directory", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_library_list", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Lists the indexed paths with their frames, snapshots and bounds", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_library_load", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Loads an indexed path into the current path, reusing the cached strategies. Usage: dolly_library_load name", PERMISSION_ALL);
+	cvarManager->registerCvar("dolly_library_cache", "64", "Memory (MB) the path library may use for decoded paths and their strategies", true, true, 1, true, 4096)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnLibraryCacheChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_shake_location", "0", "Amount (uu) of handheld shake added to the camera location", true, true, 0, true, 500)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnShakeChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_shake_rotation", "0", "Amount (degrees) of handheld shake added to the camera rotation", true, true, 0, true, 45)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnShakeChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_shake_fov", "0", "Amount of handheld shake added to the camera FOV", true, true, 0, true, 30)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnShakeChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_shake_frequency", "1", "Frequency (Hz) of the slowest shake layer", true, true, 0, true, 30)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnShakeChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_shake_layers", "3", "Amount of shake layers, every layer is twice as fast and half as strong as the previous one", true, true, 1, true, 8)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnShakeChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_shake_seed", "0", "Seed of the shake noise", true, true, 0, false)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnShakeChanged, this, _1, _2));
+	cvarManager->registerNotifier("dolly_remap_set", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Retimes the current path so pathframe is played at frame, without touching the snapshots. Usage: dolly_remap_set frame pathframe", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_remap_remove", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Removes a time remap key. Usage: dolly_remap_remove frame", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_remap_clear", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Removes every time remap key so the path plays at normal speed", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_remap_list", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Lists the time remap keys", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_target_save", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Saves the target track to a file. Usage: dolly_target_save filename", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_target_load", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Loads a target track from a file. Usage: dolly_target_load filename", PERMISSION_ALL);
+	cvarManager->registerCvar("dolly_lookat", "0", "Point the camera at the target track instead of using the rotation of the path", true, true, 0, true, 1)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnLookAtChanged, this, _1, _2));
+	cvarManager->registerNotifier("dolly_collision_load", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Loads the arena collision mesh from a .obj file in unreal units. Usage: dolly_collision_load filename", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_collision_check", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Lists the frames of the rendered path that go through the collision mesh", PERMISSION_ALL);
+	cvarManager->registerCvar("dolly_collision", "0", "Keep the camera path and playback out of the collision mesh", true, true, 0, true, 1)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnCollisionChanged, this, _1, _2));
+	cvarManager->registerCvar("dolly_collision_radius", "20", "Distance the camera is kept from the collision mesh", true, true, 0, true, 500)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnCollisionChanged, this, _1, _2));
+	cvarManager->registerNotifier("dolly_path_reduce", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Fits a spline to the current path and replaces it with the fewest snapshots within dolly_reduce_tolerance_*", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_path_smooth", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Replaces the current path with its minimum jerk curve, reduced within dolly_reduce_tolerance_*. Usage: dolly_path_smooth [stopframe ...]", PERMISSION_ALL);
+	cvarManager->registerCvar("dolly_trace", "0", "Records scoped events of editing and playback for dolly_trace_dump", true, true, 0, true, 1)
+		.addOnValueChanged(bind(&DollyCamPlugin::OnTraceChanged, this, _1, _2));
+	cvarManager->registerNotifier("dolly_trace_dump", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Writes the recorded trace events as Chrome trace JSON (open in chrome://tracing). Usage: dolly_trace_dump filename", PERMISSION_ALL);
+	cvarManager->registerNotifier("dolly_stats", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Prints min/mean/p99/max timings of the dollycam stages. Usage: dolly_stats [reset]", PERMISSION_ALL);
+
 	cvarManager->registerNotifier("dolly_cam_clone", bind(&DollyCamPlugin::OnCamCommand, this, _1), "Clones the current camera info into a snapshot", PERMISSION_REPLAY);
 	cvarManager->registerNotifier("dolly_cam_show", bind(&DollyCamPlugin::OnCamCommand, this, _1), "Prints the current camera info to the console", PERMISSION_REPLAY);
 	cvarManager->registerNotifier("dolly_cam_set_location", bind(&DollyCamPlugin::OnCamCommand, this, _1), "Sets the location of the camera to the given parameters. Usage: dolly_cam_set_location x y z", PERMISSION_REPLAY);
@@ -75,14 +138,20 @@ void DollyCamPlugin::onLoad()
 	//cvarManager->registerNotifier("dolly_live_playpath", bind(&DollyCamPlugin::OnLiveCommand, this, _1), "Plays the loaded path in the current game (REQUIRES SPECTATOR, WIP)", PERMISSION_ALL);
 
 
+	cvarManager->registerNotifier("dolly_snapshot_tcb", bind(&DollyCamPlugin::OnAllCommand, this, _1), "Shows or sets the Kochanek-Bartels tension, continuity and bias (-1 to 1) of a snapshot, used by interp mode 3. Usage: dolly_snapshot_tcb id [tension continuity bias]", PERMISSION_ALL);
 	cvarManager->registerNotifier("dolly_bezier_weight", bind(&DollyCamPlugin::OnBezierCommand, this, _1), "Change bezier weight of given snapshot (Unsupported?). Usage: dolly_bezier_weight", PERMISSION_ALL);
 	cvarManager->registerCvar("dolly_chaikin_degree", "0", "Amount of times to apply chaikin to the spline", true, true, 0, true, 20).addOnValueChanged(bind(&DollyCamPlugin::OnChaikinChanged, this, _1, _2));;
-	cvarManager->registerCvar("dolly_spline_acc", "1000", "Spline interpolation time accuracy", true, true, 100, false);
+	cvarManager->registerCvar("dolly_reduce_tolerance_location", "5", "Maximum location error (uu) allowed when reducing a path or recording", true, true, 0, false);
+	cvarManager->registerCvar("dolly_reduce_tolerance_rotation", "1", "Maximum rotation error (degrees) allowed when reducing a path or recording", true, true, 0, true, 180);
+	cvarManager->registerCvar("dolly_reduce_tolerance_fov", ".5", "Maximum FOV error allowed when reducing a path or recording", true, true, 0, false);
+	cvarManager->registerCvar("dolly_spline_acc", "1000", "Spline interpolation time accuracy", true, true, 100, false).addOnValueChanged(bind(&DollyCamPlugin::OnSplineAccuracyChanged, this, _1, _2));
 	dollyCam->SetRenderPath(true);
 }
 
 void DollyCamPlugin::onUnload()
 {
+	if (batchThread.joinable())
+		batchThread.join();
 }
 
 void DollyCamPlugin::PrintSnapshotInfo(CameraSnapshot shot)
@@ -95,6 +164,27 @@ void DollyCamPlugin::PrintSnapshotInfo(CameraSnapshot shot)
 }
 
 
+PathTolerance DollyCamPlugin::GetReduceTolerance()
+{
+	PathTolerance tolerance;
+	tolerance.location = cvarManager->getCvar("dolly_reduce_tolerance_location").getFloatValue();
+	tolerance.rotation = cvarManager->getCvar("dolly_reduce_tolerance_rotation").getFloatValue();
+	tolerance.FOV = cvarManager->getCvar("dolly_reduce_tolerance_fov").getFloatValue();
+	return tolerance;
+}
+
+ShakeSettings DollyCamPlugin::GetShakeSettings()
+{
+	ShakeSettings settings;
+	settings.location = cvarManager->getCvar("dolly_shake_location").getFloatValue();
+	settings.rotation = cvarManager->getCvar("dolly_shake_rotation").getFloatValue();
+	settings.FOV = cvarManager->getCvar("dolly_shake_fov").getFloatValue();
+	settings.frequency = cvarManager->getCvar("dolly_shake_frequency").getFloatValue();
+	settings.layers = cvarManager->getCvar("dolly_shake_layers").getIntValue();
+	settings.seed = cvarManager->getCvar("dolly_shake_seed").getIntValue();
+	return settings;
+}
+
 void DollyCamPlugin::onReplayOpen(std::string funcName)
 {
 	gameWrapper->RegisterDrawable(bind(&DollyCamPlugin::onRender, this, _1));
@@ -107,8 +197,13 @@ void DollyCamPlugin::onReplayClose(std::string funcName)
 
 void DollyCamPlugin::onTick(std::string funcName)
 {
-
-	if (!IsApplicable() || !dollyCam->IsActive())
+	if (!IsApplicable())
+		return;
+	if (dollyCam->IsRecording())
+		dollyCam->RecordTick();
+	if (dollyCam->IsRecordingTarget())
+		dollyCam->RecordTargetTick();
+	if (!dollyCam->IsActive())
 		return;
 	dollyCam->Apply();
 }
@@ -147,6 +242,360 @@ void DollyCamPlugin::OnAllCommand(vector<string> params)
 		}
 		dollyCam->LoadFromFile(filename);
 	}
+	else if (command.compare("dolly_bake_load") == 0)
+	{
+		if (params.size() < 2)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " filename");
+			return;
+		}
+		string filename = params.at(1);
+		if (!file_exists(filename))
+		{
+			cvarManager->log("File does not exist!");
+			return;
+		}
+		if (!dollyCam->LoadBakedTrack(filename))
+		{
+			cvarManager->log("File is not a valid baked track");
+			return;
+		}
+		cvarManager->executeCommand("dolly_bake_playback 1", false);
+	}
+	else if (command.compare("dolly_batch_simulate") == 0)
+	{
+		if (params.size() < 3)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " outputdirectory filename [filename ...]");
+			return;
+		}
+		BatchSettings settings;
+		settings.outputDirectory = params.at(1);
+		settings.locationInterpMode = cvarManager->getCvar("dolly_interpmode_location").getIntValue();
+		settings.rotationInterpMode = cvarManager->getCvar("dolly_interpmode_rotation").getIntValue();
+		settings.chaikinDegree = cvarManager->getCvar("dolly_chaikin_degree").getIntValue();
+		settings.splineAccuracy = cvarManager->getCvar("dolly_spline_acc").getIntValue();
+		if (gameWrapper->IsInReplay())
+			settings.replayFPS = (float)gameWrapper->GetGameEventAsReplay().GetReplayFPS();
+
+		if (batchRunning)
+		{
+			cvarManager->log("A batch is already running");
+			return;
+		}
+		if (batchThread.joinable())
+			batchThread.join();
+
+		vector<string> pathFiles(params.begin() + 2, params.end());
+		batchRunning = true;
+		cvarManager->log("Simulating " + to_string(pathFiles.size()) + " paths in the background");
+		//Workers can take a while on big batches, keep them off the game thread and log the results back on it
+		auto log = cvarManager;
+		auto game = gameWrapper;
+		batchThread = std::thread([this, settings, pathFiles, log, game]()
+		{
+			BatchSimulator simulator(settings);
+			auto results = simulator.Run(pathFiles);
+			game->Execute([log, results](GameWrapper* gw)
+			{
+				double totalMs = 0;
+				int failed = 0;
+				for (const auto& result : results)
+				{
+					if (!result.success)
+					{
+						log->log(result.pathFile + ": failed (" + result.error + ")");
+						failed++;
+						continue;
+					}
+					double pathMs = result.loadMs + result.buildMs + result.simulateMs;
+					totalMs += pathMs;
+					log->log(result.pathFile + " -> " + result.trackFile + ": " + to_string(result.snapshots) + " snapshots, " + to_string(result.frames) + " frames, load " + to_string_with_precision(result.loadMs, 3)
+						+ "ms, build " + to_string_with_precision(result.buildMs, 3) + "ms, simulate " + to_string_with_precision(result.simulateMs, 3) + "ms (worker " + to_string(result.worker) + ")");
+				}
+				log->log("Simulated " + to_string(results.size() - failed) + "/" + to_string(results.size()) + " paths, " + to_string_with_precision(totalMs, 4) + "ms total path time");
+			});
+			batchRunning = false;
+		});
+	}
+	else if (command.compare("dolly_golden_record") == 0 || command.compare("dolly_golden_compare") == 0)
+	{
+		if (params.size() < 3)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " directory filename [filename ...]");
+			return;
+		}
+		GoldenSettings settings;
+		settings.directory = params.at(1);
+		settings.splineAccuracy = cvarManager->getCvar("dolly_spline_acc").getIntValue();
+		if (gameWrapper->IsInReplay())
+			settings.replayFPS = (float)gameWrapper->GetGameEventAsReplay().GetReplayFPS();
+
+		if (batchRunning)
+		{
+			cvarManager->log("A batch is already running");
+			return;
+		}
+		if (batchThread.joinable())
+			batchThread.join();
+
+		bool record = command.compare("dolly_golden_record") == 0;
+		vector<string> pathFiles(params.begin() + 2, params.end());
+		batchRunning = true;
+		cvarManager->log((record ? "Recording " : "Comparing ") + to_string(pathFiles.size()) + " paths in the background");
+		//Every path is evaluated for every mode and Chaikin degree, same as the batch simulation keep it off the game thread
+		auto log = cvarManager;
+		auto game = gameWrapper;
+		batchThread = std::thread([this, settings, record, pathFiles, log, game]()
+		{
+			GoldenHarness harness(settings);
+			auto results = record ? harness.Record(pathFiles) : harness.Compare(pathFiles);
+			game->Execute([log, record, results](GameWrapper* gw)
+			{
+				int passed = 0;
+				for (const auto& result : results)
+				{
+					string name = result.pathFile + " (mode " + to_string(result.interpMode) + ", chaikin " + to_string(result.chaikinDegree) + ")";
+					if (!result.success)
+					{
+						log->log(name + ": failed (" + result.error + ")");
+						continue;
+					}
+					if (result.withinTolerance)
+						passed++;
+					if (record)
+					{
+						log->log(name + " -> " + result.referenceFile + ": " + to_string(result.frames) + " frames, " + to_string_with_precision(result.evaluateMs, 3) + "ms");
+						continue;
+					}
+					double speedup = result.evaluateMs > 0 ? result.referenceMs / result.evaluateMs : 0;
+					log->log(name + ": " + (result.withinTolerance ? "OK" : "MISMATCH") + ", location " + to_string_with_precision(result.maxLocationError, 4) + ", rotation " + to_string_with_precision(result.maxRotationError, 4)
+						+ " deg, FOV " + to_string_with_precision(result.maxFOVError, 4) + ", invalid frames " + to_string(result.validityMismatches) + ", " + to_string_with_precision(result.referenceMs, 3) + "ms -> "
+						+ to_string_with_precision(result.evaluateMs, 3) + "ms (" + to_string_with_precision(speedup, 3) + "x)");
+				}
+				log->log((record ? "Recorded " : "Matched ") + to_string(passed) + "/" + to_string(results.size()) + " tracks");
+			});
+			batchRunning = false;
+		});
+	}
+	else if (command.compare("dolly_track_store") == 0 || command.compare("dolly_track_edit") == 0 || command.compare("dolly_track_remove") == 0)
+	{
+		if (params.size() < 2)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " name");
+			return;
+		}
+		string name = params.at(1);
+		if (command.compare("dolly_track_store") == 0)
+		{
+			if (!dollyCam->StoreTrack(name))
+				cvarManager->log("Current path needs at least 2 snapshots to be stored as a track");
+		}
+		else if (command.compare("dolly_track_edit") == 0)
+		{
+			if (!dollyCam->EditTrack(name))
+				cvarManager->log("Track " + name + " does not exist");
+		}
+		else if (!dollyCam->RemoveTrack(name))
+		{
+			cvarManager->log("Track " + name + " does not exist");
+		}
+	}
+	else if (command.compare("dolly_track_list") == 0)
+	{
+		for (const auto& item : dollyCam->GetTracks())
+		{
+			const PathTrack& track = item.second;
+			cvarManager->log(track.name + ": frames " + to_string(track.GetStartFrame()) + "-" + to_string(track.GetEndFrame()) + ", " + to_string(track.path->size()) + " snapshots");
+		}
+		for (const auto& blend : dollyCam->GetBlends())
+		{
+			cvarManager->log("Blend " + blend.from + " -> " + blend.to + ": frames " + to_string(blend.startFrame) + "-" + to_string(blend.endFrame) + (blend.fromTrack && blend.toTrack ? "" : " (missing track)"));
+		}
+	}
+	else if (command.compare("dolly_track_blend") == 0)
+	{
+		if (params.size() < 5)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " from to startframe endframe");
+			return;
+		}
+		if (!dollyCam->AddBlend(params.at(1), params.at(2), get_safe_int(params.at(3)), get_safe_int(params.at(4))))
+			cvarManager->log("The blend needs to end after it starts");
+	}
+	else if (command.compare("dolly_track_blend_clear") == 0)
+	{
+		dollyCam->ClearBlends();
+	}
+	else if (command.compare("dolly_library_scan") == 0)
+	{
+		if (params.size() < 2)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " directory");
+			return;
+		}
+		size_t count = dollyCam->ScanLibrary(params.at(1));
+		cvarManager->log("Indexed " + to_string(count) + " paths in " + params.at(1));
+	}
+	else if (command.compare("dolly_library_list") == 0)
+	{
+		PathLibrary& library = dollyCam->GetLibrary();
+		for (const auto& entry : library.GetEntries())
+		{
+			cvarManager->log(entry.name + ": frames " + to_string(entry.startFrame) + "-" + to_string(entry.endFrame) + ", " + to_string(entry.keyframes) + " snapshots, bounds ("
+				+ vector_to_string(entry.boundsMin) + ") - (" + vector_to_string(entry.boundsMax) + ")");
+		}
+		cvarManager->log(to_string(library.GetCachedCount()) + " paths cached, " + to_string_with_precision(library.GetCachedBytes() / (1024.f * 1024.f), 3) + "MB");
+	}
+	else if (command.compare("dolly_library_load") == 0)
+	{
+		if (params.size() < 2)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " name");
+			return;
+		}
+		if (!dollyCam->LoadFromLibrary(params.at(1)))
+			cvarManager->log("Path " + params.at(1) + " is not in the library or couldn't be loaded");
+	}
+	else if (command.compare("dolly_remap_set") == 0)
+	{
+		if (params.size() < 3)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " frame pathframe");
+			return;
+		}
+		if (!dollyCam->SetTimeRemapKey(get_safe_int(params.at(1)), get_safe_float(params.at(2))))
+			cvarManager->log("Path frames have to increase with the frame, the path can't run backwards");
+	}
+	else if (command.compare("dolly_remap_remove") == 0)
+	{
+		if (params.size() < 2)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " frame");
+			return;
+		}
+		if (!dollyCam->RemoveTimeRemapKey(get_safe_int(params.at(1))))
+			cvarManager->log("Frame " + params.at(1) + " has no time remap key");
+	}
+	else if (command.compare("dolly_remap_clear") == 0)
+	{
+		dollyCam->ClearTimeRemap();
+	}
+	else if (command.compare("dolly_remap_list") == 0)
+	{
+		for (const auto& key : dollyCam->GetTimeRemap().GetKeys())
+			cvarManager->log("Frame " + to_string(key.first) + " -> path frame " + to_string_with_precision(key.second, 2));
+	}
+	else if (command.compare("dolly_target_save") == 0 || command.compare("dolly_target_load") == 0)
+	{
+		if (params.size() < 2)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " filename");
+			return;
+		}
+		if (command.compare("dolly_target_save") == 0)
+		{
+			if (!dollyCam->SaveTargetTrack(params.at(1)))
+				cvarManager->log("Could not save the target track to " + params.at(1));
+		}
+		else if (!dollyCam->LoadTargetTrack(params.at(1)))
+		{
+			cvarManager->log("Could not load a target track from " + params.at(1));
+		}
+	}
+	else if (command.compare("dolly_snapshot_tcb") == 0)
+	{
+		if (params.size() != 2 && params.size() != 5)
+		{
+			cvarManager->log("Usage: " + command + " id [tension continuity bias]");
+			return;
+		}
+		int id = get_safe_int(params.at(1));
+		if (!dollyCam->IsFrameUsed(id))
+		{
+			cvarManager->log("Frame #" + to_string(id) + " does not have a snapshot attached");
+			return;
+		}
+		CameraSnapshot snapshot = dollyCam->GetSnapshot(id);
+		if (params.size() == 5)
+		{
+			snapshot.tension = (std::max)(-1.f, (std::min)(1.f, get_safe_float(params.at(2))));
+			snapshot.continuity = (std::max)(-1.f, (std::min)(1.f, get_safe_float(params.at(3))));
+			snapshot.bias = (std::max)(-1.f, (std::min)(1.f, get_safe_float(params.at(4))));
+			dollyCam->InsertSnapshot(snapshot);
+		}
+		cvarManager->log("Snapshot #" + to_string(snapshot.frame) + " tension: " + to_string_with_precision(snapshot.tension, 2) + ", continuity: " + to_string_with_precision(snapshot.continuity, 2) + ", bias: " + to_string_with_precision(snapshot.bias, 2));
+	}
+	else if (command.compare("dolly_collision_load") == 0)
+	{
+		if (params.size() < 2)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " filename");
+			return;
+		}
+		if (!dollyCam->LoadCollisionMesh(params.at(1)))
+			cvarManager->log("Could not load a collision mesh from " + params.at(1));
+	}
+	else if (command.compare("dolly_collision_check") == 0)
+	{
+		dollyCam->CheckCollisions();
+	}
+	else if (command.compare("dolly_path_reduce") == 0)
+	{
+		dollyCam->ReducePath(GetReduceTolerance());
+	}
+	else if (command.compare("dolly_path_smooth") == 0)
+	{
+		std::vector<int> stopFrames;
+		for (size_t i = 1; i < params.size(); i++)
+			stopFrames.push_back(get_safe_int(params.at(i)));
+		dollyCam->OptimizePath(GetReduceTolerance(), stopFrames);
+	}
+	else if (command.compare("dolly_trace_dump") == 0)
+	{
+		if (params.size() < 2)
+		{
+			cvarManager->log("Usage: " + params.at(0) + " filename");
+			return;
+		}
+		int events = WriteTrace(params.at(1));
+		if (events < 0)
+		{
+			cvarManager->log("Could not write trace to " + params.at(1));
+			return;
+		}
+		cvarManager->log("Wrote " + to_string(events) + " trace events to " + params.at(1));
+	}
+	else if (command.compare("dolly_stats") == 0)
+	{
+		if (params.size() > 1 && params.at(1).compare("reset") == 0)
+		{
+			ResetStageHistograms();
+			cvarManager->log("Stats reset");
+			return;
+		}
+		for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+		{
+			cvarManager->log(GetStageStatsLine((ProfileStage)stage));
+		}
+	}
+}
+
+string DollyCamPlugin::GetStageStatsLine(ProfileStage stage)
+{
+	LatencyStats stats = GetStageHistogram(stage).GetStats();
+	string line = string(GetProfileStageName(stage)) + ": " + to_string(stats.count) + " samples, min " + to_string_with_precision(stats.minUs, 4) + "us, mean " + to_string_with_precision(stats.meanUs, 4)
+		+ "us, p99 " + to_string_with_precision(stats.p99Us, 4) + "us, max " + to_string_with_precision(stats.maxUs, 4) + "us";
+	if (IsAllocationCountingEnabled())
+	{
+		AllocationStats allocations = GetStageAllocations(stage);
+		double perCall = stats.count > 0 ? (double)allocations.allocations / stats.count : 0;
+		line += ", " + to_string(allocations.allocations) + " allocations (" + to_string_with_precision(perCall, 3) + " per call), " + to_string(allocations.bytes) + " bytes";
+		//Playback runs these every tick, they should not allocate at all
+		if ((stage == PROFILE_APPLY || stage == PROFILE_GETPOV) && perCall > 0)
+			line += ", OVER BUDGET (0 allocations per call)";
+	}
+	return line;
 }
 
 
@@ -225,7 +674,20 @@ void DollyCamPlugin::OnInReplayCommand(vector<string> params)
 		return;
 	}
 	std::string command = params.at(0);
-	if (command.compare("dolly_replayinfo") == 0)
+	if (command.compare("dolly_bake") == 0)
+	{
+		if (!dollyCam->Bake())
+		{
+			cvarManager->log("Failed to bake the current path");
+			return;
+		}
+		if (params.size() > 1 && !dollyCam->SaveBakedTrack(params.at(1)))
+		{
+			cvarManager->log("Failed to save baked track to " + params.at(1));
+		}
+		cvarManager->executeCommand("dolly_bake_playback 1", false);
+	}
+	else if (command.compare("dolly_replayinfo") == 0)
 	{
 		ReplayServerWrapper replayServer = gameWrapper->GetGameEventAsReplay();
 		ReplayDirectorWrapper replayDirector = replayServer.GetReplayDirector();
@@ -280,6 +742,27 @@ void DollyCamPlugin::OnReplayCommand(vector<string> params)
 	{
 		dollyCam->Activate();
 	}
+	else if (command.compare("dolly_record_start") == 0)
+	{
+		if (dollyCam->IsActive())
+		{
+			cvarManager->log("Deactivate the dollycam before recording");
+			return;
+		}
+		dollyCam->StartRecording(GetReduceTolerance());
+	}
+	else if (command.compare("dolly_record_stop") == 0)
+	{
+		dollyCam->StopRecording();
+	}
+	else if (command.compare("dolly_target_record_start") == 0)
+	{
+		dollyCam->StartTargetRecording();
+	}
+	else if (command.compare("dolly_target_record_stop") == 0)
+	{
+		dollyCam->StopTargetRecording();
+	}
 }
 
 void DollyCamPlugin::OnSnapshotCommand(vector<string> params)
@@ -448,11 +931,13 @@ void DollyCamPlugin::OnInterpModeChanged(string oldValue, CVarWrapper newCvar)
 	else if(cvarName.compare("dolly_interpmode_location") == 0)
 	{
 		dollyCam->RefreshInterpData();
+		dollyCam->RebuildTracks();
 		cvarManager->log("Now using " + dollyCam->GetInterpolationMethod(true) + " for camera location.");
 	}
 	else if(cvarName.compare("dolly_interpmode_rotation") == 0)
 	{
 		dollyCam->RefreshInterpDataRotation();
+		dollyCam->RebuildTracks();
 		cvarManager->log("Now using " + dollyCam->GetInterpolationMethod(false) + " for camera rotation.");
 	}
 }
@@ -462,9 +947,64 @@ void DollyCamPlugin::OnRenderFramesChanged(string oldValue, CVarWrapper newCvar)
 	dollyCam->SetRenderFrames(newCvar.getBoolValue());
 }
 
+void DollyCamPlugin::OnRenderLODChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->SetRenderLOD(newCvar.getFloatValue());
+}
+
+void DollyCamPlugin::OnMotionOverlayChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->SetMotionOverlay(newCvar.getIntValue() - 1);
+}
+
+void DollyCamPlugin::OnSplineAccuracyChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->RefreshInterpData();
+	dollyCam->RefreshInterpDataRotation();
+	dollyCam->RebuildTracks();
+}
+
+void DollyCamPlugin::OnTraceChanged(string oldValue, CVarWrapper newCvar)
+{
+	if (newCvar.getBoolValue() && !IsTracingEnabled())
+		ClearTrace();
+	SetTracingEnabled(newCvar.getBoolValue());
+}
+
+void DollyCamPlugin::OnBakePlaybackChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->SetPlayBakedTrack(newCvar.getBoolValue());
+}
+
+void DollyCamPlugin::OnLookAtChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->SetLookAtTarget(newCvar.getBoolValue());
+}
+
+void DollyCamPlugin::OnCollisionChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->SetCollisionAvoidance(cvarManager->getCvar("dolly_collision").getBoolValue(), cvarManager->getCvar("dolly_collision_radius").getFloatValue());
+}
+
+void DollyCamPlugin::OnShakeChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->SetShake(GetShakeSettings());
+}
+
+void DollyCamPlugin::OnLibraryCacheChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->GetLibrary().SetMemoryCap((size_t)newCvar.getIntValue() * 1024 * 1024);
+}
+
+void DollyCamPlugin::OnTrackPlaybackChanged(string oldValue, CVarWrapper newCvar)
+{
+	dollyCam->SetPlayTracks(newCvar.getBoolValue());
+}
+
 void DollyCamPlugin::OnChaikinChanged(string oldValue, CVarWrapper newCvar)
 {
 	dollyCam->RefreshInterpData();
+	dollyCam->RebuildTracks();
 }
 
 void DollyCamPlugin::OnBezierCommand(vector<string> params)
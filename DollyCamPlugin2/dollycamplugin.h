@@ -1,8 +1,12 @@
 #pragma once
 #pragma comment(lib, "BakkesMod.lib")
+#include <thread>
+#include <atomic>
 #include "bakkesmod\plugin\bakkesmodplugin.h"
 #include "bakkesmod\plugin\pluginwindow.h"
 #include "dollycam.h"
+#include "profiler.h"
+#include "tracing.h"
 
 class DollyCamPlugin : public BakkesMod::Plugin::BakkesModPlugin, public BakkesMod::Plugin::PluginWindow
 {
@@ -11,11 +15,31 @@ private:
 	std::shared_ptr<bool> renderCameraPath;
 	CameraSnapshot selectedSnapshot;
 	bool IsApplicable();
+	PathTolerance GetReduceTolerance();
+	ShakeSettings GetShakeSettings();
+	//Runs dolly_batch_simulate and the golden harness, only one batch at a time
+	std::thread batchThread;
+	std::atomic<bool> batchRunning{ false };
 
 	//gui stuff
 	bool isWindowOpen = true;
 	bool isMinimized = false;
 	bool block_input = false;
+	//Formatted snapshot table cells, rebuilt when the path revision changes
+	std::vector<std::vector<std::string>> snapshotRows;
+	unsigned int snapshotRowsRevision = 0;
+	bool snapshotRowsValid = false;
+	void UpdateSnapshotRows();
+	std::vector<float> statsBuckets;
+	//Formatted library rows, rebuilt when the library index changes
+	std::vector<std::string> libraryRows;
+	unsigned int libraryRowsRevision = 0;
+	bool libraryRowsValid = false;
+	void RenderSnapshotTable(int totalWidth);
+	void RenderStats(int totalWidth);
+	void RenderLibrary(int totalWidth);
+	void RenderMotion(int totalWidth);
+	string GetStageStatsLine(ProfileStage stage);
 
 public:
 	virtual void onLoad();
@@ -43,7 +67,17 @@ public:
 	//Cvar change listeners
 	void OnInterpModeChanged(string oldValue, CVarWrapper newCvar);
 	void OnRenderFramesChanged(string oldValue, CVarWrapper newCvar);
+	void OnRenderLODChanged(string oldValue, CVarWrapper newCvar);
+	void OnMotionOverlayChanged(string oldValue, CVarWrapper newCvar);
 	void OnChaikinChanged(string oldValue, CVarWrapper newCvar);
+	void OnSplineAccuracyChanged(string oldValue, CVarWrapper newCvar);
+	void OnBakePlaybackChanged(string oldValue, CVarWrapper newCvar);
+	void OnTrackPlaybackChanged(string oldValue, CVarWrapper newCvar);
+	void OnLibraryCacheChanged(string oldValue, CVarWrapper newCvar);
+	void OnShakeChanged(string oldValue, CVarWrapper newCvar);
+	void OnLookAtChanged(string oldValue, CVarWrapper newCvar);
+	void OnCollisionChanged(string oldValue, CVarWrapper newCvar);
+	void OnTraceChanged(string oldValue, CVarWrapper newCvar);
 
 	//Interp config methods
 	void OnBezierCommand(vector<string> params);
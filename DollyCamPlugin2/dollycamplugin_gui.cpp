@@ -1,6 +1,8 @@
 #include "dollycamplugin.h"
 #include "imgui\imgui.h"
 #include "imgui\imgui_internal.h"
+#include "imgui\imgui_tabs.h"
+#include "imgui\imguivariouscontrols.h"
 #include "serialization.h"
 #include "bakkesmod\..\\utils\parser.h"
 #include <functional>
@@ -14,31 +16,32 @@ namespace Columns
 		int width;
 		bool enabled;
 		bool widget;
-		std::function<string(CameraSnapshot, int)> ToString;
-		std::function<void(std::shared_ptr<DollyCam>, CameraSnapshot, int)> WidgetCode;
+		std::function<string(const CameraSnapshot&, int)> ToString;
+		std::function<void(std::shared_ptr<DollyCam>, int)> WidgetCode;
 
 		int GetWidth() const { return enabled ? width : 0; }
-		void RenderItem(std::shared_ptr<DollyCam> dollyCam, CameraSnapshot snap, int i) const {
+		void RenderItem(std::shared_ptr<DollyCam> dollyCam, const string& text, int i) const {
 			if (!enabled) return;
 			if (widget) 
 			{
-				WidgetCode(dollyCam, snap, i);
+				WidgetCode(dollyCam, i);
 			}
 			else {
-				ImGui::Text(ToString(snap, i).c_str());
+				ImGui::TextUnformatted(text.c_str());
 			}
 		}
 	};
-	auto noWidget = [](std::shared_ptr<DollyCam> dollyCam, CameraSnapshot snap, int i) {};
+	auto noWidget = [](std::shared_ptr<DollyCam> dollyCam, int i) {};
 	vector< TableColumns > column {
-		{"#",			25,		true, false, [](CameraSnapshot snap, int i) {return to_string(i); },								noWidget},
-		{"Frame",		40,		true, false, [](CameraSnapshot snap, int i) {return to_string(snap.frame); },						noWidget},
-		{"Time",		60,		true, false, [](CameraSnapshot snap, int i) {return to_string_with_precision(snap.timeStamp, 2); }, noWidget},
-		{"Location",	200,	true, false, [](CameraSnapshot snap, int i) {return vector_to_string(snap.location); },				noWidget},
-		{"Rotation",	140,	true, false, [](CameraSnapshot snap, int i) {return rotator_to_string(snap.rotation.ToRotator()); },noWidget},
-		{"FOV",			40,		true, false, [](CameraSnapshot snap, int i) {return to_string_with_precision(snap.FOV, 1); },		noWidget},
-		{"Remove",		80,		true, true, [](CameraSnapshot snap, int i) {return ""; },
-			[](std::shared_ptr<DollyCam> dollyCam, CameraSnapshot snap, int i) {
+		{"#",			25,		true, false, [](const CameraSnapshot& snap, int i) {return to_string(i); },								noWidget},
+		{"Frame",		40,		true, false, [](const CameraSnapshot& snap, int i) {return to_string(snap.frame); },						noWidget},
+		{"Time",		60,		true, false, [](const CameraSnapshot& snap, int i) {return to_string_with_precision(snap.timeStamp, 2); }, noWidget},
+		{"Location",	200,	true, false, [](const CameraSnapshot& snap, int i) {return vector_to_string(snap.location); },				noWidget},
+		{"Rotation",	140,	true, false, [](const CameraSnapshot& snap, int i) {return rotator_to_string(snap.rotation.ToRotator()); },noWidget},
+		{"FOV",			40,		true, false, [](const CameraSnapshot& snap, int i) {return to_string_with_precision(snap.FOV, 1); },		noWidget},
+		{"TCB",			90,		true, false, [](const CameraSnapshot& snap, int i) {return to_string_with_precision(snap.tension, 2) + " " + to_string_with_precision(snap.continuity, 2) + " " + to_string_with_precision(snap.bias, 2); }, noWidget},
+		{"Remove",		80,		true, true, [](const CameraSnapshot& snap, int i) {return ""; },
+			[](std::shared_ptr<DollyCam> dollyCam, int i) {
 				string buttonIdentifier = "Remove##" + to_string(i);
 				if (ImGui::Button(buttonIdentifier.c_str()))
 				{
@@ -48,10 +51,34 @@ namespace Columns
 	};
 }
 
+void DollyCamPlugin::UpdateSnapshotRows()
+{
+	unsigned int revision = dollyCam->GetPathRevision();
+	if (snapshotRowsValid && snapshotRowsRevision == revision)
+		return;
+
+	const auto& columns = Columns::column;
+	auto path = dollyCam->GetCurrentPath();
+	snapshotRows.resize(path->size());
+	int index = 1;
+	for (const auto& data : *path)
+	{
+		auto& row = snapshotRows[index - 1];
+		row.resize(columns.size());
+		for (size_t col = 0; col < columns.size(); col++)
+		{
+			if (columns[col].enabled && !columns[col].widget)
+				row[col] = columns[col].ToString(data.second, index);
+		}
+		index++;
+	}
+	snapshotRowsRevision = revision;
+	snapshotRowsValid = true;
+}
 
 void DollyCamPlugin::Render()
 {
-	auto columns = Columns::column;
+	const auto& columns = Columns::column;
 	int totalWidth = std::accumulate(columns.begin(), columns.end(), 0, [](int sum, const Columns::TableColumns& element) {return sum + element.GetWidth(); });
 	ImGui::SetNextWindowSizeConstraints(ImVec2(totalWidth, 300), ImVec2(FLT_MAX, FLT_MAX));
 
@@ -69,6 +96,38 @@ void DollyCamPlugin::Render()
 		return;
 	}
 
+	ImGui::BeginTabBar("#DollyCamTabs");
+	ImGui::DrawTabsBackground();
+	if (ImGui::AddTab("Snapshots"))
+	{
+		RenderSnapshotTable(totalWidth);
+	}
+	if (ImGui::AddTab("Library"))
+	{
+		RenderLibrary(totalWidth);
+	}
+	if (ImGui::AddTab("Motion"))
+	{
+		RenderMotion(totalWidth);
+	}
+	if (ImGui::AddTab("Stats"))
+	{
+		RenderStats(totalWidth);
+	}
+	ImGui::EndTabBar();
+	ImGui::End();
+
+	if (!isWindowOpen)
+	{
+		cvarManager->executeCommand("togglemenu " + GetMenuName());
+	}
+	block_input = ImGui::GetIO().WantCaptureMouse || ImGui::GetIO().WantCaptureKeyboard;
+
+}
+
+void DollyCamPlugin::RenderSnapshotTable(int totalWidth)
+{
+	const auto& columns = Columns::column;
 	int enabledCount = std::accumulate(columns.begin(), columns.end(), 0, [](int sum, const Columns::TableColumns& element) {return sum + element.enabled; });
 	ImGui::BeginChild("#CurrentSnapshotsTab", ImVec2(totalWidth, -ImGui::GetFrameHeightWithSpacing()));
 	ImGui::Columns(enabledCount, "snapshots");
@@ -99,31 +158,118 @@ void DollyCamPlugin::Render()
 
 	ImGui::Separator();
 
-	//Write rows of data
-	index = 1;
-	for (const auto& data : *dollyCam->GetCurrentPath())
+	//Write rows of data, only the rows that are scrolled into view are submitted
+	UpdateSnapshotRows();
+	ImGuiListClipper clipper((int)snapshotRows.size());
+	while (clipper.Step())
 	{
-		auto snapshot = data.second;
-		for (const auto& col : columns)
+		for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
 		{
-			if (col.enabled)
+			const auto& cells = snapshotRows[row];
+			for (size_t col = 0; col < columns.size(); col++)
 			{
-				col.RenderItem(dollyCam, snapshot, index);
-				ImGui::NextColumn();
+				if (columns[col].enabled)
+				{
+					columns[col].RenderItem(dollyCam, cells[col], row + 1);
+					ImGui::NextColumn();
+				}
 			}
 		}
-		index++;
 	}
 
 	ImGui::EndChild();
-	ImGui::End();
+}
 
-	if (!isWindowOpen)
+void DollyCamPlugin::RenderStats(int totalWidth)
+{
+	ImGui::BeginChild("#StatsTab", ImVec2(totalWidth, -ImGui::GetFrameHeightWithSpacing()));
+	if (ImGui::Button("Reset"))
 	{
-		cvarManager->executeCommand("togglemenu " + GetMenuName());
+		ResetStageHistograms();
 	}
-	block_input = ImGui::GetIO().WantCaptureMouse || ImGui::GetIO().WantCaptureKeyboard;
+	for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+	{
+		ImGui::TextUnformatted(GetStageStatsLine((ProfileStage)stage).c_str());
+		GetStageHistogram((ProfileStage)stage).GetBucketCounts(statsBuckets);
+		if (statsBuckets.empty())
+			continue;
+		string label = "##stats" + to_string(stage);
+		ImGui::PlotHistogram2(label.c_str(), statsBuckets.data(), (int)statsBuckets.size(), 0, NULL, 0, FLT_MAX, ImVec2(totalWidth - 20, 50));
+	}
+	ImGui::EndChild();
+}
 
+void DollyCamPlugin::RenderLibrary(int totalWidth)
+{
+	PathLibrary& library = dollyCam->GetLibrary();
+	const auto& entries = library.GetEntries();
+	if (!libraryRowsValid || libraryRowsRevision != library.GetRevision())
+	{
+		libraryRows.clear();
+		for (const auto& entry : entries)
+			libraryRows.push_back(entry.name + "  frames " + to_string(entry.startFrame) + "-" + to_string(entry.endFrame) + ", " + to_string(entry.keyframes) + " snapshots");
+		libraryRowsRevision = library.GetRevision();
+		libraryRowsValid = true;
+	}
+
+	ImGui::BeginChild("#LibraryTab", ImVec2(totalWidth, -ImGui::GetFrameHeightWithSpacing()));
+	if (entries.empty())
+	{
+		ImGui::TextUnformatted("No paths indexed, use dolly_library_scan directory");
+	}
+	ImGuiListClipper clipper((int)libraryRows.size());
+	while (clipper.Step())
+	{
+		for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+		{
+			string buttonIdentifier = "Load##library" + to_string(row);
+			if (ImGui::Button(buttonIdentifier.c_str()))
+			{
+				dollyCam->LoadFromLibrary(entries[row].name);
+			}
+			ImGui::SameLine();
+			ImGui::TextUnformatted(libraryRows[row].c_str());
+		}
+	}
+	ImGui::EndChild();
+}
+
+//PlotCurve getter, x is a fractional index into the channel
+static float GetMotionValue(void* data, float x, int numCurve)
+{
+	const auto& values = *static_cast<const std::vector<float>*>(data);
+	if (values.empty())
+		return 0;
+	float index = (std::max)(0.f, (std::min)(x, (float)(values.size() - 1)));
+	size_t whole = (size_t)index;
+	if (whole + 1 >= values.size())
+		return values[whole];
+	return values[whole] + (values[whole + 1] - values[whole]) * (index - whole);
+}
+
+void DollyCamPlugin::RenderMotion(int totalWidth)
+{
+	const PathMotion& motion = dollyCam->GetRenderPathMotion();
+	ImGui::BeginChild("#MotionTab", ImVec2(totalWidth, -ImGui::GetFrameHeightWithSpacing()));
+	if (motion.GetPointCount() < 2)
+	{
+		ImGui::TextUnformatted("No render path, enable dolly_render in a replay");
+		ImGui::EndChild();
+		return;
+	}
+	const auto& frames = motion.GetFrames();
+	string frameRange = "Frames " + to_string(frames.front()) + " - " + to_string(frames.back());
+	ImGui::TextUnformatted(frameRange.c_str());
+	for (int channel = 0; channel < MOTION_CHANNEL_COUNT; channel++)
+	{
+		MotionChannel motionChannel = (MotionChannel)channel;
+		float max = motion.GetMax(motionChannel);
+		string overlay = string(PathMotion::GetChannelName(motionChannel)) + ", max " + to_string_with_precision(max, 1);
+		string label = "##motion" + to_string(channel);
+		ImGui::PlotCurve(label.c_str(), GetMotionValue, (void*)&motion.GetChannel(motionChannel), 1, overlay.c_str(),
+			ImVec2(0, (std::max)(max * 1.1f, 1.f)), ImVec2(0, (float)(motion.GetPointCount() - 1)), ImVec2(totalWidth - 20, 80));
+	}
+	ImGui::EndChild();
 }
 
 std::string DollyCamPlugin::GetMenuName()
@@ -2,6 +2,9 @@
 #include "bakkesmod\wrappers\GameObject\CameraWrapper.h"
 #include <iostream>
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
 
 
 RealGameApplier::RealGameApplier(std::shared_ptr<GameWrapper> gw) : gameWrapper(gw)
@@ -21,17 +24,34 @@ NewPOV RealGameApplier::GetPOV()
 }
 
 
-MockGameApplier::MockGameApplier(string filename)
+MockGameApplier::MockGameApplier(string filename, MockOutputFormat _format, size_t bufferSize) : format(_format)
 {
-	output.open(filename, ios::out | ios::trunc);
+	output.open(filename, ios::out | ios::trunc | (format == MOCK_OUTPUT_BINARY ? ios::binary : ios::out));
+	buffer.resize(bufferSize < 256 ? 256 : bufferSize);
 }
 
 MockGameApplier::~MockGameApplier()
 {
-	output.flush();
+	Flush();
 	output.close();
 }
 
+void MockGameApplier::Write(const char* data, size_t size)
+{
+	if (bufferUsed + size > buffer.size())
+		Flush();
+	memcpy(buffer.data() + bufferUsed, data, size);
+	bufferUsed += size;
+}
+
+void MockGameApplier::Flush()
+{
+	if (bufferUsed > 0)
+		output.write(buffer.data(), bufferUsed);
+	bufferUsed = 0;
+	output.flush();
+}
+
 void MockGameApplier::SetTime(float t)
 {
 	time = t;
@@ -41,7 +61,18 @@ void MockGameApplier::SetPOV(Vector location, CustomRotator rotation, float FOV)
 {
 	NewPOV newpov = { location, rotation, FOV };
 	pov = newpov;
-	output << time << "," << location.X << "," << location.Y << "," << location.Z << endl;
+	if (format == MOCK_OUTPUT_BINARY)
+	{
+		float sample[8] = { time, location.X, location.Y, location.Z, rotation.Pitch._value, rotation.Yaw._value, rotation.Roll._value, FOV };
+		Write(reinterpret_cast<const char*>(sample), sizeof(sample));
+	}
+	else
+	{
+		char line[256];
+		int length = snprintf(line, sizeof(line), "%g,%g,%g,%g,%g,%g,%g,%g\n", time, location.X, location.Y, location.Z, rotation.Pitch._value, rotation.Yaw._value, rotation.Roll._value, FOV);
+		if (length > 0)
+			Write(line, (std::min)((size_t)length, sizeof(line) - 1));
+	}
 }
 
 NewPOV MockGameApplier::GetPOV()
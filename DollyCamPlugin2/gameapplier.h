@@ -3,6 +3,7 @@
 #include "utils\customrotator.h"
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include "models.h"
 
 //Interface for applying stuff to the game which will help with simulations
@@ -23,16 +24,28 @@ public:
 	NewPOV GetPOV();
 };
 
+enum MockOutputFormat
+{
+	MOCK_OUTPUT_CSV, //time,x,y,z,pitch,yaw,roll,fov per line
+	MOCK_OUTPUT_BINARY //8 floats per sample in the same order
+};
+
 //Mock game applier for simulating data
 class MockGameApplier : public IGameApplier {
 private:
 	ofstream output;
+	MockOutputFormat format;
+	std::vector<char> buffer;
+	size_t bufferUsed = 0;
 	NewPOV pov;
-	float time;
+	float time = 0.f;
+	void Write(const char* data, size_t size);
 public:
-	MockGameApplier(string filename);
+	MockGameApplier(string filename, MockOutputFormat format = MOCK_OUTPUT_CSV, size_t bufferSize = 1 << 16);
 	~MockGameApplier();
 	void SetTime(float time);
 	void SetPOV(Vector location, CustomRotator rotation, float FOV);
 	NewPOV GetPOV();
+	//Writes the buffered samples to the file
+	void Flush();
 };
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "goldenharness.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include "bakedtrack.h"
+#include "serialization.h"
+#include "pathtiming.h"
+#include "interpstrategies/strategyfactory.h"
+
+#define EVALUATE_RUNS 3 //Fastest run is used to keep timings stable
+
+static BakedTrack EvaluateTrack(InterpStrategy& strategy, const savetype& path, const std::vector<float>& frameTimes)
+{
+	BakedTrack track(path.begin()->first);
+	for (size_t i = 0; i < frameTimes.size(); i++)
+		track.AddFrame(strategy.GetPOV(frameTimes[i], track.GetStartFrame() + (int)i));
+	return track;
+}
+
+GoldenHarness::GoldenHarness(GoldenSettings _settings) : settings(_settings)
+{
+}
+
+std::string GoldenHarness::GetReferenceFile(const std::string& pathFile, int interpMode, int chaikinDegree) const
+{
+	size_t nameStart = pathFile.find_last_of("/\\");
+	std::string name = nameStart == std::string::npos ? pathFile : pathFile.substr(nameStart + 1);
+	size_t extension = name.find_last_of('.');
+	if (extension != std::string::npos)
+		name = name.substr(0, extension);
+	return name + "_m" + std::to_string(interpMode) + "_c" + std::to_string(chaikinDegree) + ".dcbt";
+}
+
+std::string GoldenHarness::GetManifestFile() const
+{
+	return settings.directory + "/golden.txt";
+}
+
+std::map<std::string, double> GoldenHarness::LoadManifest() const
+{
+	std::map<std::string, double> manifest;
+	std::ifstream file(GetManifestFile());
+	std::string referenceFile;
+	double evaluateMs;
+	while (file >> referenceFile >> evaluateMs)
+		manifest[referenceFile] = evaluateMs;
+	return manifest;
+}
+
+bool GoldenHarness::SaveManifest(const std::map<std::string, double>& manifest) const
+{
+	std::ofstream file(GetManifestFile(), std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+	for (const auto& item : manifest)
+		file << item.first << " " << item.second << "\n";
+	return file.good();
+}
+
+template <typename Action>
+std::vector<GoldenResult> GoldenHarness::ForEachTrack(const std::vector<std::string>& pathFiles, Action action)
+{
+	std::vector<GoldenResult> results;
+	for (const auto& pathFile : pathFiles)
+	{
+		std::shared_ptr<savetype> path;
+		std::string loadError;
+		try
+		{
+			path = std::make_shared<savetype>(LoadPathFromFile(pathFile));
+			if (path->size() < 2)
+				loadError = "path needs at least 2 snapshots";
+		}
+		catch (const std::exception& e)
+		{
+			loadError = e.what();
+		}
+		std::vector<float> frameTimes;
+		if (loadError.empty())
+			frameTimes = BuildFrameTimes(*path, 1.f / settings.replayFPS);
+
+		for (int interpMode : settings.interpModes)
+		{
+			for (int chaikinDegree : settings.chaikinDegrees)
+			{
+				GoldenResult result;
+				result.pathFile = pathFile;
+				result.referenceFile = GetReferenceFile(pathFile, interpMode, chaikinDegree);
+				result.interpMode = interpMode;
+				result.chaikinDegree = chaikinDegree;
+				result.error = loadError;
+				if (loadError.empty())
+				{
+					try
+					{
+						auto strategy = CreateInterpStrategy(interpMode, path, chaikinDegree, settings.splineAccuracy);
+						if (!strategy)
+							throw std::runtime_error("unknown interp mode");
+						BakedTrack track;
+						for (int run = 0; run < EVALUATE_RUNS; run++)
+						{
+							auto start = std::chrono::steady_clock::now();
+							track = EvaluateTrack(*strategy, *path, frameTimes);
+							double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+							if (run == 0 || ms < result.evaluateMs)
+								result.evaluateMs = ms;
+						}
+						result.frames = track.GetFrameCount();
+						action(result, track);
+					}
+					catch (const std::exception& e)
+					{
+						result.error = e.what();
+						result.success = false;
+					}
+				}
+				results.push_back(result);
+			}
+		}
+	}
+	return results;
+}
+
+std::vector<GoldenResult> GoldenHarness::Record(const std::vector<std::string>& pathFiles)
+{
+	auto manifest = LoadManifest();
+	auto results = ForEachTrack(pathFiles, [&](GoldenResult& result, const BakedTrack& track)
+	{
+		if (!track.SaveToFile(settings.directory + "/" + result.referenceFile))
+			throw std::runtime_error("could not write " + result.referenceFile);
+		manifest[result.referenceFile] = result.evaluateMs;
+		result.referenceMs = result.evaluateMs;
+		result.success = true;
+		result.withinTolerance = true;
+	});
+	SaveManifest(manifest);
+	return results;
+}
+
+std::vector<GoldenResult> GoldenHarness::Compare(const std::vector<std::string>& pathFiles)
+{
+	auto manifest = LoadManifest();
+	return ForEachTrack(pathFiles, [&](GoldenResult& result, const BakedTrack& track)
+	{
+		BakedTrack reference;
+		if (!reference.LoadFromFile(settings.directory + "/" + result.referenceFile))
+			throw std::runtime_error("no reference track " + result.referenceFile);
+		if (reference.GetStartFrame() != track.GetStartFrame() || reference.GetFrameCount() != track.GetFrameCount())
+			throw std::runtime_error("frame range differs from reference");
+		auto referenceTime = manifest.find(result.referenceFile);
+		if (referenceTime != manifest.end())
+			result.referenceMs = referenceTime->second;
+
+		for (int frame = track.GetStartFrame(); frame <= track.GetEndFrame(); frame++)
+		{
+			NewPOV expected, actual;
+			bool expectedValid = reference.GetFrame(frame, expected);
+			bool actualValid = track.GetFrame(frame, actual);
+			if (expectedValid != actualValid)
+				result.validityMismatches++;
+			if (!expectedValid || !actualValid)
+				continue;
+
+			Vector offset = actual.location - expected.location;
+			result.maxLocationError = (std::max)(result.maxLocationError, sqrt(offset.X * offset.X + offset.Y * offset.Y + offset.Z * offset.Z));
+			CustomRotator rotationOffset = expected.rotation.diffTo(actual.rotation);
+			float rotationError = (std::max)(fabs(rotationOffset.Pitch._value), (std::max)(fabs(rotationOffset.Yaw._value), fabs(rotationOffset.Roll._value)));
+			result.maxRotationError = (std::max)(result.maxRotationError, rotationError / ROTATOR_UNITS_PER_DEGREE);
+			result.maxFOVError = (std::max)(result.maxFOVError, fabs(actual.FOV - expected.FOV));
+		}
+		result.success = true;
+		result.withinTolerance = result.validityMismatches == 0 && result.maxLocationError <= settings.tolerance.location
+			&& result.maxRotationError <= settings.tolerance.rotation && result.maxFOVError <= settings.tolerance.FOV;
+	});
+}
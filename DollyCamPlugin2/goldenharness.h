@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include "models.h"
+
+struct GoldenSettings
+{
+	std::vector<int> interpModes = { 0, 1, 2, 3, 4, 5 };
+	std::vector<int> chaikinDegrees = { 0, 1, 2 };
+	int splineAccuracy = 1000;
+	float replayFPS = 30.f;
+	std::string directory = ".";
+	PathTolerance tolerance = { .01f, .01f, .001f };
+};
+
+struct GoldenResult
+{
+	std::string pathFile;
+	std::string referenceFile;
+	int interpMode = 0;
+	int chaikinDegree = 0;
+	bool success = false;
+	std::string error;
+	size_t frames = 0;
+	size_t validityMismatches = 0; //Frames where only one of the tracks has a valid camera state
+	float maxLocationError = 0;
+	float maxRotationError = 0; //Degrees
+	float maxFOVError = 0;
+	double referenceMs = 0;
+	double evaluateMs = 0;
+	bool withinTolerance = false;
+};
+
+//Stores reference tracks of saved paths for every interp mode and chaikin degree, and compares the current strategies against them
+//so optimized strategies can be checked for accuracy and speed against the implementation the references were recorded with
+class GoldenHarness
+{
+private:
+	GoldenSettings settings;
+	std::string GetReferenceFile(const std::string& pathFile, int interpMode, int chaikinDegree) const;
+	std::string GetManifestFile() const;
+	std::map<std::string, double> LoadManifest() const;
+	bool SaveManifest(const std::map<std::string, double>& manifest) const;
+	template <typename Action>
+	std::vector<GoldenResult> ForEachTrack(const std::vector<std::string>& pathFiles, Action action);
+
+public:
+	GoldenHarness(GoldenSettings settings);
+	//Evaluates the current strategies and stores the result as the new reference
+	std::vector<GoldenResult> Record(const std::vector<std::string>& pathFiles);
+	std::vector<GoldenResult> Compare(const std::vector<std::string>& pathFiles);
+};
@@ -1,9 +1,11 @@
 #include "catmullrominterp.h"
+#include "../tracing.h"
 
 
 
 CatmullRomInterpStrategy::CatmullRomInterpStrategy(std::shared_ptr<savetype> _camPath, int chaikinDegree)
 {
+	TRACE_SCOPE("CatmullRomInterpStrategy");
 	setCamPath(_camPath, chaikinDegree);
 	linearInterp = std::make_shared<LinearInterpStrategy>(LinearInterpStrategy(_camPath, chaikinDegree));
 }
@@ -58,9 +60,36 @@ CustomRotator catmullRom(float t, CustomRotator p0, CustomRotator p1, CustomRota
 
 	//return pos;
 }
+//First and second derivative of the cubic to t
+void GetCatmullRomDerivatives(float t, float p0, float p1, float p2, float p3, float& first, float& second)
+{
+	float c = 2 * p0 - 5 * p1 + 4 * p2 - p3;
+	float d = 3 * p1 - p0 - 3 * p2 + p3;
+	first = 0.5f * ((p2 - p0) + 2 * c * t + 3 * d * t * t);
+	second = 0.5f * (2 * c + 6 * d * t);
+}
 
+Vector catmullRomDerivative(float t, Vector p0, Vector p1, Vector p2, Vector p3, Vector& second)
+{
+	Vector first;
+	GetCatmullRomDerivatives(t, p0.X, p1.X, p2.X, p3.X, first.X, second.X);
+	GetCatmullRomDerivatives(t, p0.Y, p1.Y, p2.Y, p3.Y, first.Y, second.Y);
+	GetCatmullRomDerivatives(t, p0.Z, p1.Z, p2.Z, p3.Z, first.Z, second.Z);
+	return first;
+}
 
 NewPOV CatmullRomInterpStrategy::GetPOV(float gameTime, int latestFrame)
+{
+	return Evaluate(gameTime, latestFrame, nullptr);
+}
+
+NewPOV CatmullRomInterpStrategy::GetPOVAndDerivatives(float gameTime, int latestFrame, MotionDerivatives& derivatives)
+{
+	derivatives.valid = false;
+	return Evaluate(gameTime, latestFrame, &derivatives);
+}
+
+NewPOV CatmullRomInterpStrategy::Evaluate(float gameTime, int latestFrame, MotionDerivatives* derivatives)
 {
 	if (camPath->size() < 4) //Need atleast 4 elements
 		return{ 0 };
@@ -101,6 +130,23 @@ NewPOV CatmullRomInterpStrategy::GetPOV(float gameTime, int latestFrame)
 	newPov.rotation = catmullRom(percElapsed, startSnapshot->second.rotation, currentSnapshot->second.rotation, nextSnapshot->second.rotation, nextNextSnapshot->second.rotation);
 	newPov.FOV = GetCatmullRomPosition(percElapsed, startSnapshot->second.FOV, currentSnapshot->second.FOV, nextSnapshot->second.FOV, nextNextSnapshot->second.FOV);
 	//newPov.FOV = 90;
+	if (derivatives && totalDiff > 0)
+	{
+		//The curve is parameterized by the fraction of the segment, scale to seconds
+		Vector second;
+		const auto& p0 = startSnapshot->second.rotation;
+		const auto& p1 = currentSnapshot->second.rotation;
+		const auto& p2 = nextSnapshot->second.rotation;
+		const auto& p3 = nextNextSnapshot->second.rotation;
+		Vector rotation0(p0.Pitch._value, p0.Yaw._value, p0.Roll._value);
+		Vector rotation1(p1.Pitch._value, p1.Yaw._value, p1.Roll._value);
+		Vector rotation2(p2.Pitch._value, p2.Yaw._value, p2.Roll._value);
+		Vector rotation3(p3.Pitch._value, p3.Yaw._value, p3.Roll._value);
+		derivatives->angularVelocity = catmullRomDerivative(percElapsed, rotation0, rotation1, rotation2, rotation3, second) * (1.f / totalDiff);
+		derivatives->velocity = catmullRomDerivative(percElapsed, startSnapshot->second.location, currentSnapshot->second.location, nextSnapshot->second.location, nextNextSnapshot->second.location, second) * (1.f / totalDiff);
+		derivatives->acceleration = second * (1.f / (totalDiff * totalDiff));
+		derivatives->valid = true;
+	}
 	return newPov;
 }
 
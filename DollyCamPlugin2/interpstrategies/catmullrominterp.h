@@ -5,8 +5,10 @@ class CatmullRomInterpStrategy : public InterpStrategy
 {
 private:
 	std::shared_ptr<LinearInterpStrategy> linearInterp;
+	NewPOV Evaluate(float gameTime, int latestFrame, MotionDerivatives* derivatives);
 public:
 	CatmullRomInterpStrategy(std::shared_ptr<savetype> _camPath, int chaikinDegree);
 	virtual NewPOV GetPOV(float gameTime, int latestFrame);
+	virtual NewPOV GetPOVAndDerivatives(float gameTime, int latestFrame, MotionDerivatives& derivatives);
 	virtual std::string GetName();
 };
\ No newline at end of file
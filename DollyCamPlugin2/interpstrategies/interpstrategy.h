@@ -11,6 +11,8 @@ protected:
 public:
 
 	virtual NewPOV GetPOV(float gameTime, int latestFrame) = 0;
+	//Same as GetPOV, also fills in the derivatives for strategies that have them analytically
+	virtual NewPOV GetPOVAndDerivatives(float gameTime, int latestFrame, MotionDerivatives& derivatives);
 	virtual std::string GetName() = 0;
 };
 
@@ -26,11 +28,3 @@ public:
 	virtual std::string GetName();
 };
 
-class HermiteInterpStrategy : public InterpStrategy
-{
-public:
-	HermiteInterpStrategy(std::shared_ptr<savetype> _camPath);
-	virtual NewPOV GetPOV(float gameTime, int latestFrame);
-	virtual std::string GetName();
-};
-
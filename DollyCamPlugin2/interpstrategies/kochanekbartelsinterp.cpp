@@ -0,0 +1,151 @@
+#include "kochanekbartelsinterp.h"
+#include "../tracing.h"
+#include <algorithm>
+
+#define MIN_SEGMENT_DURATION .0001f
+
+KochanekBartelsInterpStrategy::KochanekBartelsInterpStrategy(std::shared_ptr<savetype> _camPath, int chaikinDegree)
+{
+	TRACE_SCOPE("KochanekBartelsInterpStrategy");
+	setCamPath(_camPath, chaikinDegree);
+	BuildSegments();
+}
+
+void KochanekBartelsInterpStrategy::BuildSegments()
+{
+	segments.clear();
+	size_t n = camPath->size();
+	if (n < 2)
+		return;
+
+	std::vector<const CameraSnapshot*> keys;
+	std::vector<float> values(n * CHANNELS);
+	keys.reserve(n);
+	auto previousRotation = camPath->begin()->second.rotation;
+	float accumulatedPitch = previousRotation.Pitch._value;
+	float accumulatedYaw = previousRotation.Yaw._value;
+	float accumulatedRoll = previousRotation.Roll._value;
+	for (const auto& item : *camPath)
+	{
+		const CameraSnapshot& snapshot = item.second;
+		auto diffRotation = previousRotation.diffTo(snapshot.rotation);
+		accumulatedPitch += diffRotation.Pitch._value;
+		accumulatedYaw += diffRotation.Yaw._value;
+		accumulatedRoll += diffRotation.Roll._value;
+		previousRotation = snapshot.rotation;
+
+		float* key = &values[keys.size() * CHANNELS];
+		key[0] = snapshot.location.X;
+		key[1] = snapshot.location.Y;
+		key[2] = snapshot.location.Z;
+		key[3] = accumulatedPitch;
+		key[4] = accumulatedYaw;
+		key[5] = accumulatedRoll;
+		key[6] = snapshot.FOV;
+		keys.push_back(&snapshot);
+	}
+
+	std::vector<float> durations(n - 1);
+	for (size_t i = 0; i + 1 < n; i++)
+		durations[i] = (std::max)(keys[i + 1]->timeStamp - keys[i]->timeStamp, MIN_SEGMENT_DURATION);
+
+	//Outgoing and incoming tangent of every key, the ends reuse their only neighbouring chord on both sides
+	std::vector<float> outgoing(n * CHANNELS), incoming(n * CHANNELS);
+	for (size_t i = 0; i < n; i++)
+	{
+		float tension = keys[i]->tension, continuity = keys[i]->continuity, bias = keys[i]->bias;
+		float outFromPrevious = (1 - tension) * (1 + continuity) * (1 + bias) / 2;
+		float outFromNext = (1 - tension) * (1 - continuity) * (1 - bias) / 2;
+		float inFromPrevious = (1 - tension) * (1 - continuity) * (1 + bias) / 2;
+		float inFromNext = (1 - tension) * (1 + continuity) * (1 - bias) / 2;
+		size_t previous = i > 0 ? i - 1 : i;
+		size_t next = i + 1 < n ? i + 1 : i;
+		for (int c = 0; c < CHANNELS; c++)
+		{
+			float chordPrevious = i > 0 ? values[i * CHANNELS + c] - values[previous * CHANNELS + c] : values[next * CHANNELS + c] - values[i * CHANNELS + c];
+			float chordNext = i + 1 < n ? values[next * CHANNELS + c] - values[i * CHANNELS + c] : chordPrevious;
+			outgoing[i * CHANNELS + c] = outFromPrevious * chordPrevious + outFromNext * chordNext;
+			incoming[i * CHANNELS + c] = inFromPrevious * chordPrevious + inFromNext * chordNext;
+		}
+	}
+
+	segments.resize(n - 1);
+	for (size_t i = 0; i + 1 < n; i++)
+	{
+		Segment& segment = segments[i];
+		segment.startFrame = keys[i]->frame;
+		segment.endFrame = keys[i + 1]->frame;
+		segment.startTime = keys[i]->timeStamp;
+		segment.duration = durations[i];
+
+		//Keeps the speed continuous across keys when the segments around them take different amounts of time
+		float duration = durations[i];
+		float outScale = i > 0 ? 2 * duration / (durations[i - 1] + duration) : 1.f;
+		float inScale = i + 2 < n ? 2 * duration / (duration + durations[i + 1]) : 1.f;
+		for (int c = 0; c < CHANNELS; c++)
+		{
+			float p0 = values[i * CHANNELS + c];
+			float p1 = values[(i + 1) * CHANNELS + c];
+			float m0 = outgoing[i * CHANNELS + c] * outScale;
+			float m1 = incoming[(i + 1) * CHANNELS + c] * inScale;
+			segment.coefficients[c][0] = p0;
+			segment.coefficients[c][1] = m0;
+			segment.coefficients[c][2] = 3 * (p1 - p0) - 2 * m0 - m1;
+			segment.coefficients[c][3] = 2 * (p0 - p1) + m0 + m1;
+		}
+	}
+}
+
+NewPOV KochanekBartelsInterpStrategy::GetPOV(float gameTime, int latestFrame)
+{
+	return Evaluate(gameTime, latestFrame, nullptr);
+}
+
+NewPOV KochanekBartelsInterpStrategy::GetPOVAndDerivatives(float gameTime, int latestFrame, MotionDerivatives& derivatives)
+{
+	derivatives.valid = false;
+	return Evaluate(gameTime, latestFrame, &derivatives);
+}
+
+NewPOV KochanekBartelsInterpStrategy::Evaluate(float gameTime, int latestFrame, MotionDerivatives* derivatives)
+{
+	if (segments.empty() || latestFrame < segments.front().startFrame || latestFrame >= segments.back().endFrame) //We're at the end of the playback
+		return{ Vector(0), CustomRotator(0,0,0), 0 };
+
+	auto next = std::upper_bound(segments.begin(), segments.end(), latestFrame, [](int frame, const Segment& segment) { return frame < segment.startFrame; });
+	const Segment& segment = *std::prev(next);
+	float s = (std::max)(0.f, (std::min)(1.f, (gameTime - segment.startTime) / segment.duration));
+
+	float result[CHANNELS];
+	for (int c = 0; c < CHANNELS; c++)
+	{
+		const float* k = segment.coefficients[c];
+		result[c] = k[0] + s * (k[1] + s * (k[2] + s * k[3]));
+	}
+
+	if (derivatives)
+	{
+		float first[CHANNELS], second[CHANNELS];
+		for (int c = 0; c < CHANNELS; c++)
+		{
+			const float* k = segment.coefficients[c];
+			first[c] = (k[1] + s * (2 * k[2] + s * 3 * k[3])) / segment.duration;
+			second[c] = (2 * k[2] + 6 * k[3] * s) / (segment.duration * segment.duration);
+		}
+		derivatives->velocity = Vector(first[0], first[1], first[2]);
+		derivatives->acceleration = Vector(second[0], second[1], second[2]);
+		derivatives->angularVelocity = Vector(first[3], first[4], first[5]);
+		derivatives->valid = true;
+	}
+
+	NewPOV newPov;
+	newPov.location = Vector(result[0], result[1], result[2]);
+	newPov.rotation = CustomRotator(result[3], result[4], result[5]);
+	newPov.FOV = result[6];
+	return newPov;
+}
+
+std::string KochanekBartelsInterpStrategy::GetName()
+{
+	return "Kochanek-Bartels interpolation";
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+#include "interpstrategy.h"
+
+//Cubic Hermite curve with Kochanek-Bartels tangents, shaped by the tension, continuity and bias of every snapshot.
+//Tangents are adjusted for uneven time between snapshots and baked into one cubic per segment and channel when the strategy is built
+class KochanekBartelsInterpStrategy : public InterpStrategy
+{
+private:
+	enum { CHANNELS = 7 }; //x, y, z, unwrapped pitch, yaw, roll, FOV
+
+	struct Segment
+	{
+		int startFrame;
+		int endFrame;
+		float startTime;
+		float duration;
+		float coefficients[CHANNELS][4]; //c0 + c1*s + c2*s^2 + c3*s^3 for s from 0 to 1 over the segment
+	};
+
+	std::vector<Segment> segments;
+	void BuildSegments();
+	NewPOV Evaluate(float gameTime, int latestFrame, MotionDerivatives* derivatives);
+
+public:
+	KochanekBartelsInterpStrategy(std::shared_ptr<savetype> _camPath, int chaikinDegree);
+	virtual NewPOV GetPOV(float gameTime, int latestFrame);
+	virtual NewPOV GetPOVAndDerivatives(float gameTime, int latestFrame, MotionDerivatives& derivatives);
+	virtual std::string GetName();
+};
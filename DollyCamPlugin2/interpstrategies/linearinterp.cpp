@@ -1,7 +1,9 @@
 #include "linearinterp.h"
+#include "../tracing.h"
 
 LinearInterpStrategy::LinearInterpStrategy(std::shared_ptr<savetype> _camPath, int degree)
 {
+	TRACE_SCOPE("LinearInterpStrategy");
 	setCamPath(_camPath, degree);
 	//camPath = std::make_unique<savetype>(*_camPath); //Copy campath
 }
@@ -1,9 +1,11 @@
 #include "nbezierinterp.h"
+#include "../tracing.h"
 
 
 
 NBezierInterpStrategy::NBezierInterpStrategy(std::shared_ptr<savetype> _camPath, int degree)
 {
+	TRACE_SCOPE("NBezierInterpStrategy");
 	setCamPath(_camPath, degree);
 }
 
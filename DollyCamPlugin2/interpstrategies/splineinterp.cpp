@@ -1,6 +1,9 @@
 #include <map>
 #include "splineinterp.h"
 #include "nbezierinterp.h"
+#include "../tracing.h"
+#include <algorithm>
+#include <cmath>
 //#include "bakkesmod\wrappers\wrapperstructs.h"
 
 vector<tinyspline::real> SolveForT(tinyspline::BSpline &spline, float tGoal, float e, int maxSteps = 50)
@@ -32,13 +35,66 @@ vector<tinyspline::real> SolveForT(tinyspline::BSpline &spline, float tGoal, flo
 }
 
 
-SplineInterpStrategy::SplineInterpStrategy(std::shared_ptr<savetype> _camPath, int degree)
+SplineInterpStrategy::SplineInterpStrategy(std::shared_ptr<savetype> _camPath, int degree, int _accuracy) : accuracy(_accuracy)
 {
+	TRACE_SCOPE("SplineInterpStrategy");
 	setCamPath(_camPath, degree);
 	backupStrategy = std::make_shared<NBezierInterpStrategy>(NBezierInterpStrategy(_camPath, degree));
 }
 
+//Derivatives to time of a spline that has time as its first dimension, at the point net was evaluated at.
+//interpolateCubic returns a sequence of bezier segments whose inner knots have a higher multiplicity than the degree,
+//derive() refuses those, so the derivatives come from the control points of the segment the net landed in
+static bool GetTimeDerivatives(const tinyspline::BSpline& spline, const tinyspline::DeBoorNet& net, double* first, double* second)
+{
+	const size_t order = 4;
+	size_t dim = spline.dimension();
+	if (spline.degree() != order - 1 || dim < 2)
+		return false;
+	auto controlPoints = spline.controlPoints();
+	auto knots = spline.knots();
+	size_t segments = controlPoints.size() / (dim * order);
+	if (segments == 0)
+		return false;
+	size_t segment = (std::min)(net.index() / order, segments - 1);
+	double from = knots[segment * order];
+	double to = knots[segment * order + order];
+	if (to - from <= 0)
+		return false;
+	double s = (std::max)(0.0, (std::min)(1.0, (net.knot() - from) / (to - from)));
+
+	const tinyspline::real* p = &controlPoints[segment * order * dim];
+	double du[8], duu[8];
+	for (size_t d = 0; d < dim && d < 8; d++)
+	{
+		double d0 = p[dim + d] - p[d], d1 = p[2 * dim + d] - p[dim + d], d2 = p[3 * dim + d] - p[2 * dim + d];
+		du[d] = 3 * ((1 - s) * (1 - s) * d0 + 2 * (1 - s) * s * d1 + s * s * d2) / (to - from);
+		duu[d] = 6 * ((1 - s) * (d1 - d0) + s * (d2 - d1)) / ((to - from) * (to - from));
+	}
+	//Chain rule through the time dimension
+	double timeRate = du[0];
+	if (fabs(timeRate) < 1e-9)
+		return false;
+	for (size_t d = 1; d < dim && d < 8; d++)
+	{
+		first[d - 1] = du[d] / timeRate;
+		second[d - 1] = (duu[d] * timeRate - du[d] * duu[0]) / (timeRate * timeRate * timeRate);
+	}
+	return true;
+}
+
 NewPOV SplineInterpStrategy::GetPOV(float gameTime, int latestFrame)
+{
+	return Evaluate(gameTime, latestFrame, nullptr);
+}
+
+NewPOV SplineInterpStrategy::GetPOVAndDerivatives(float gameTime, int latestFrame, MotionDerivatives& derivatives)
+{
+	derivatives.valid = false;
+	return Evaluate(gameTime, latestFrame, &derivatives);
+}
+
+NewPOV SplineInterpStrategy::Evaluate(float gameTime, int latestFrame, MotionDerivatives* derivatives)
 {
 	//auto t = GetRelativeTime(gameTime);
 	auto t = GetRelativeTimeFromFrame(latestFrame);
@@ -47,6 +103,8 @@ NewPOV SplineInterpStrategy::GetPOV(float gameTime, int latestFrame)
 	int n = camPath->size();
 	if (n < 4)
 	{
+		if (derivatives)
+			return backupStrategy->GetPOVAndDerivatives(gameTime, latestFrame, *derivatives);
 		return backupStrategy->GetPOV(gameTime, latestFrame);
 	}
 	auto nextSnapshot = camPath->upper_bound(latestFrame);
@@ -58,11 +116,25 @@ NewPOV SplineInterpStrategy::GetPOV(float gameTime, int latestFrame)
 	InitPositions(n);
 	InitRotations(n);
 	InitFOVs(n);
-	int accuracy = cvarManager->getCvar("dolly_spline_acc").getIntValue();
 	float epsilon = 1.0 / accuracy; // Acceptable error is 1 / 1000 seconds.
-	auto posRes = camPositions.bisect(gameTime, epsilon).result();
-	auto rotRes = camRotations.bisect(gameTime, epsilon).result();
-	auto fovRes = camFOVs.bisect(gameTime, epsilon).result();
+	std::vector<tinyspline::real> posRes, rotRes, fovRes;
+	{
+		TRACE_SCOPE("bisect");
+		auto posNet = camPositions.bisect(gameTime, epsilon);
+		auto rotNet = camRotations.bisect(gameTime, epsilon);
+		posRes = posNet.result();
+		rotRes = rotNet.result();
+		fovRes = camFOVs.bisect(gameTime, epsilon).result();
+
+		double velocity[3], acceleration[3], angularVelocity[3], angularAcceleration[3];
+		if (derivatives && GetTimeDerivatives(camPositions, posNet, velocity, acceleration) && GetTimeDerivatives(camRotations, rotNet, angularVelocity, angularAcceleration))
+		{
+			derivatives->velocity = Vector(float(velocity[0]), float(velocity[1]), float(velocity[2]));
+			derivatives->acceleration = Vector(float(acceleration[0]), float(acceleration[1]), float(acceleration[2]));
+			derivatives->angularVelocity = Vector(float(angularVelocity[0]), float(angularVelocity[1]), float(angularVelocity[2]));
+			derivatives->valid = true;
+		}
+	}
 
 
 	Vector v;
@@ -1,18 +1,18 @@
 #pragma once
 #include "interpstrategy.h"
 #include "tinyspline\tinysplinecpp.h"
-#include "bakkesmod\plugin\bakkesmodplugin.h"
 
 
 class SplineInterpStrategy : public InterpStrategy
 {
 public:
-	SplineInterpStrategy(std::shared_ptr<savetype> _camPath, int degree);
+	SplineInterpStrategy(std::shared_ptr<savetype> _camPath, int degree, int accuracy);
 	virtual NewPOV GetPOV(float gameTime, int latestFrame);
+	virtual NewPOV GetPOVAndDerivatives(float gameTime, int latestFrame, MotionDerivatives& derivatives);
 	virtual std::string GetName();
-	std::shared_ptr<CVarManagerWrapper> cvarManager;
 
 private:
+	NewPOV Evaluate(float gameTime, int latestFrame, MotionDerivatives* derivatives);
 	float GetRelativeTime(float gameTime);
 
 	float GetRelativeTimeFromFrame(int frame);
@@ -26,4 +26,5 @@ private:
 	tinyspline::BSpline camFOVs;
 
 	std::shared_ptr<InterpStrategy> backupStrategy;
+	int accuracy;
 };
\ No newline at end of file
@@ -0,0 +1,22 @@
+#include "strategyfactory.h"
+#include "supportedstrategies.h"
+
+std::shared_ptr<InterpStrategy> CreateInterpStrategy(int interpStrategy, std::shared_ptr<savetype> path, int chaikinDegree, int splineAccuracy)
+{
+	switch (interpStrategy)
+	{
+	case 0:
+		return std::make_shared<LinearInterpStrategy>(LinearInterpStrategy(path, chaikinDegree));
+	case 1:
+		return std::make_shared<NBezierInterpStrategy>(NBezierInterpStrategy(path, chaikinDegree));
+	case 2:
+		return std::make_shared<CosineInterpStrategy>(CosineInterpStrategy(path));
+	case 3:
+		return std::make_shared<KochanekBartelsInterpStrategy>(KochanekBartelsInterpStrategy(path, chaikinDegree));
+	case 4:
+		return std::make_shared<CatmullRomInterpStrategy>(CatmullRomInterpStrategy(path, chaikinDegree));
+	case 5:
+		return std::make_shared<SplineInterpStrategy>(SplineInterpStrategy(path, chaikinDegree, splineAccuracy));
+	}
+	return nullptr;
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include "interpstrategy.h"
+
+//Builds the interp strategy with the given id (see dolly_interpmode), returns nullptr for unknown ids
+std::shared_ptr<InterpStrategy> CreateInterpStrategy(int interpStrategy, std::shared_ptr<savetype> path, int chaikinDegree, int splineAccuracy);
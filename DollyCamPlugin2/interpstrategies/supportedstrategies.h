@@ -3,4 +3,5 @@
 #include "linearinterp.h"
 #include "nbezierinterp.h"
 #include "catmullrominterp.h"
-#include "splineinterp.h"
\ No newline at end of file
+#include "splineinterp.h"
+#include "kochanekbartelsinterp.h"
\ No newline at end of file
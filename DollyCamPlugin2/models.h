@@ -2,6 +2,14 @@
 #include "utils\customrotator.h"
 #define savetype std::map<int, CameraSnapshot>
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+//Rotators use 65536 units for a full turn
+#define UNREAL_TO_RADIANS (M_PI / 32768.0)
+#define RADIANS_TO_UNREAL (32768.0 / M_PI)
+#define ROTATOR_UNITS_PER_DEGREE (65536.f / 360.f)
+
 struct NewPOV
 {
 	Vector location;
@@ -10,6 +18,15 @@ struct NewPOV
 	POV ToPOV();
 };
 
+//Rates of change of the camera per second, valid is false when a strategy can't compute them analytically
+struct MotionDerivatives
+{
+	bool valid = false;
+	Vector velocity;
+	Vector acceleration;
+	Vector angularVelocity; //Pitch, yaw and roll in rotator units
+};
+
 struct CameraSnapshot
 {
 	//int id; 
@@ -20,4 +37,16 @@ struct CameraSnapshot
 	CustomRotator rotation;
 
 	float weight = 1.f;
+	//Kochanek-Bartels parameters of the curve through this snapshot, all 0 is a Catmull-Rom curve
+	float tension = 0.f;
+	float continuity = 0.f;
+	float bias = 0.f;
+};
+
+//Error bounds used when reducing a dense camera path to keyframes
+struct PathTolerance
+{
+	float location = 5.f; //Unreal units
+	float rotation = 1.f; //Degrees
+	float FOV = .5f;
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "pathblend.h"
+#include <cmath>
+#include <algorithm>
+
+#define SINGULARITY_THRESHOLD .4999995
+
+struct Quaternion
+{
+	double x, y, z, w;
+};
+
+//Same conventions as Unreals FRotator::Quaternion and FQuat::Rotator
+static Quaternion ToQuaternion(const CustomRotator& rotator)
+{
+	double sp = sin(rotator.Pitch._value * UNREAL_TO_RADIANS * .5), cp = cos(rotator.Pitch._value * UNREAL_TO_RADIANS * .5);
+	double sy = sin(rotator.Yaw._value * UNREAL_TO_RADIANS * .5), cy = cos(rotator.Yaw._value * UNREAL_TO_RADIANS * .5);
+	double sr = sin(rotator.Roll._value * UNREAL_TO_RADIANS * .5), cr = cos(rotator.Roll._value * UNREAL_TO_RADIANS * .5);
+	return { cr * sp * sy - sr * cp * cy, -cr * sp * cy - sr * cp * sy, cr * cp * sy - sr * sp * cy, cr * cp * cy + sr * sp * sy };
+}
+
+static CustomRotator ToRotator(const Quaternion& q)
+{
+	double singularityTest = q.z * q.x - q.w * q.y;
+	double yaw = atan2(2 * (q.w * q.z + q.x * q.y), 1 - 2 * (q.y * q.y + q.z * q.z));
+	double pitch, roll;
+	if (singularityTest < -SINGULARITY_THRESHOLD)
+	{
+		pitch = -M_PI / 2;
+		roll = -yaw - 2 * atan2(q.x, q.w);
+	}
+	else if (singularityTest > SINGULARITY_THRESHOLD)
+	{
+		pitch = M_PI / 2;
+		roll = yaw - 2 * atan2(q.x, q.w);
+	}
+	else
+	{
+		pitch = asin(2 * singularityTest);
+		roll = atan2(-2 * (q.w * q.x + q.y * q.z), 1 - 2 * (q.x * q.x + q.y * q.y));
+	}
+	roll = remainder(roll, 2 * M_PI);
+	return CustomRotator(float(pitch / UNREAL_TO_RADIANS), float(yaw / UNREAL_TO_RADIANS), float(roll / UNREAL_TO_RADIANS));
+}
+
+CustomRotator SlerpRotation(const CustomRotator& from, const CustomRotator& to, float t)
+{
+	Quaternion a = ToQuaternion(from);
+	Quaternion b = ToQuaternion(to);
+	double cosAngle = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	//q and -q are the same rotation, flipping one takes the short way around
+	if (cosAngle < 0)
+	{
+		b = { -b.x, -b.y, -b.z, -b.w };
+		cosAngle = -cosAngle;
+	}
+	double weightA = 1 - t, weightB = t;
+	//Nearly identical rotations are lerped, the slerp weights lose precision there
+	if (cosAngle < .9999)
+	{
+		double angle = acos(cosAngle);
+		double sinAngle = sin(angle);
+		weightA = sin((1 - t) * angle) / sinAngle;
+		weightB = sin(t * angle) / sinAngle;
+	}
+	Quaternion q = { weightA * a.x + weightB * b.x, weightA * a.y + weightB * b.y, weightA * a.z + weightB * b.z, weightA * a.w + weightB * b.w };
+	double length = sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+	q = { q.x / length, q.y / length, q.z / length, q.w / length };
+
+	//Keep the winding of from so playback doesn't jump by a full turn
+	return from + from.diffTo(ToRotator(q));
+}
+
+NewPOV BlendPOV(const NewPOV& from, const NewPOV& to, float weight)
+{
+	NewPOV pov;
+	pov.location = from.location + (to.location - from.location) * weight;
+	pov.rotation = SlerpRotation(from.rotation, to.rotation, weight);
+	pov.FOV = from.FOV + (to.FOV - from.FOV) * weight;
+	return pov;
+}
+
+bool TrackBlend::Contains(int frame) const
+{
+	return fromTrack && toTrack && frame >= startFrame && frame <= endFrame;
+}
+
+float TrackBlend::GetWeight(float frame) const
+{
+	if (endFrame <= startFrame)
+		return 1.f;
+	float t = (std::max)(0.f, (std::min)((frame - startFrame) / float(endFrame - startFrame), 1.f));
+	return t * t * (3 - 2 * t);
+}
+
+NewPOV TrackBlend::Evaluate(float frame, int currentFrame) const
+{
+	//The fractional frame is looked up once, each track maps it to its own replay time
+	NewPOV fromPov = fromTrack->Evaluate(fromTrack->frameTimes.GetTime(frame), currentFrame);
+	NewPOV toPov = toTrack->Evaluate(toTrack->frameTimes.GetTime(frame), currentFrame);
+	if (fromPov.FOV < 1)
+		return toPov;
+	if (toPov.FOV < 1)
+		return fromPov;
+	return BlendPOV(fromPov, toPov, GetWeight(frame));
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include "models.h"
+#include "pathtrack.h"
+
+//Cross-fade from one track to another over a range of frames. Both tracks are evaluated at the same fractional frame,
+//location is mixed with an eased weight, rotation with a quaternion slerp and FOV linearly
+struct TrackBlend
+{
+	std::string from;
+	std::string to;
+	int startFrame = 0;
+	int endFrame = 0;
+	//Resolved whenever the tracks change, null while the track doesn't exist
+	const PathTrack* fromTrack = nullptr;
+	const PathTrack* toTrack = nullptr;
+
+	bool Contains(int frame) const;
+	//Smoothstep over the blend range, 0 at the start and 1 at the end
+	float GetWeight(float frame) const;
+	NewPOV Evaluate(float frame, int currentFrame) const;
+};
+
+//Shortest arc between two rotations, the result is unwound to stay close to from
+CustomRotator SlerpRotation(const CustomRotator& from, const CustomRotator& to, float t);
+//Mixes two valid camera states, weight 0 gives from and 1 gives to
+NewPOV BlendPOV(const NewPOV& from, const NewPOV& to, float weight);
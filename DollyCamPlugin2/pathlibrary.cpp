@@ -0,0 +1,284 @@
+#define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
+#include "pathlibrary.h"
+#include "serialization.h"
+#include "tracing.h"
+#include <experimental/filesystem>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <exception>
+
+namespace fs = std::experimental::filesystem;
+
+static uint64_t HashContents(const std::string& contents)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (unsigned char c : contents)
+	{
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static bool ReadContents(const std::string& file, std::string& contents)
+{
+	std::ifstream stream(file, std::ios::in | std::ios::binary);
+	if (!stream.is_open())
+		return false;
+	std::ostringstream buffer;
+	buffer << stream.rdbuf();
+	contents = buffer.str();
+	return true;
+}
+
+static void Summarize(const savetype& path, PathIndexEntry& entry)
+{
+	entry.keyframes = path.size();
+	if (path.empty())
+		return;
+	entry.startFrame = path.begin()->first;
+	entry.endFrame = (--path.end())->first;
+	entry.boundsMin = path.begin()->second.location;
+	entry.boundsMax = entry.boundsMin;
+	for (const auto& item : path)
+	{
+		const Vector& location = item.second.location;
+		entry.boundsMin = Vector((std::min)(entry.boundsMin.X, location.X), (std::min)(entry.boundsMin.Y, location.Y), (std::min)(entry.boundsMin.Z, location.Z));
+		entry.boundsMax = Vector((std::max)(entry.boundsMax.X, location.X), (std::max)(entry.boundsMax.Y, location.Y), (std::max)(entry.boundsMax.Z, location.Z));
+	}
+}
+
+//Decoded path and frame times, the strategies are estimated by whoever builds them
+static size_t EstimatePathBytes(const PathTrack& track)
+{
+	//Map nodes hold three links and a color next to the value
+	size_t snapshotBytes = sizeof(savetype::value_type) + 4 * sizeof(void*);
+	return sizeof(PathTrack) + track.path->size() * snapshotBytes + track.frameTimes.GetTimes().size() * sizeof(float);
+}
+
+PathLibrary::PathLibrary(StrategyBuilder _buildStrategies, size_t _memoryCap) : buildStrategies(_buildStrategies), memoryCap(_memoryCap)
+{
+}
+
+size_t PathLibrary::Scan(const std::string& _directory)
+{
+	TRACE_SCOPE("PathLibrary::Scan");
+	if (_directory != directory)
+	{
+		entries.clear();
+		cache.clear();
+		recentlyUsed.clear();
+		cachedBytes = 0;
+		directory = _directory;
+	}
+
+	std::vector<PathIndexEntry> scanned;
+	std::error_code error;
+	for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+	{
+		if (!fs::is_regular_file(it->status()))
+			continue;
+		PathIndexEntry entry;
+		entry.file = it->path().string();
+		entry.name = it->path().filename().string();
+		entry.fileSize = fs::file_size(it->path(), error);
+		entry.writeTime = (long long)fs::last_write_time(it->path(), error).time_since_epoch().count();
+		if (error)
+		{
+			error.clear();
+			continue;
+		}
+
+		const PathIndexEntry* previous = FindEntry(entry.name);
+		if (previous && previous->fileSize == entry.fileSize && previous->writeTime == entry.writeTime)
+		{
+			scanned.push_back(*previous);
+			continue;
+		}
+
+		std::string contents;
+		if (!ReadContents(entry.file, contents))
+			continue;
+		try
+		{
+			Summarize(LoadPathFromString(contents), entry);
+		}
+		catch (const std::exception&)
+		{
+			//Not a path file
+			continue;
+		}
+		entry.hash = HashContents(contents);
+		scanned.push_back(entry);
+	}
+	std::sort(scanned.begin(), scanned.end(), [](const PathIndexEntry& a, const PathIndexEntry& b) { return a.name < b.name; });
+	entries.swap(scanned);
+
+	//Cached paths that were deleted or changed on disk are decoded again the next time they are used
+	std::vector<std::string> stale;
+	for (const auto& item : cache)
+	{
+		const PathIndexEntry* entry = FindEntry(item.first);
+		if (!entry || entry->hash != item.second.hash)
+			stale.push_back(item.first);
+	}
+	for (const auto& name : stale)
+		Remove(name);
+
+	revision++;
+	return entries.size();
+}
+
+const std::string& PathLibrary::GetDirectory() const
+{
+	return directory;
+}
+
+const std::vector<PathIndexEntry>& PathLibrary::GetEntries() const
+{
+	return entries;
+}
+
+unsigned int PathLibrary::GetRevision() const
+{
+	return revision;
+}
+
+PathIndexEntry* PathLibrary::FindEntry(const std::string& name)
+{
+	auto it = std::lower_bound(entries.begin(), entries.end(), name, [](const PathIndexEntry& entry, const std::string& name) { return entry.name < name; });
+	if (it == entries.end() || it->name != name)
+		return nullptr;
+	return &*it;
+}
+
+const PathIndexEntry* PathLibrary::Find(const std::string& name) const
+{
+	return const_cast<PathLibrary*>(this)->FindEntry(name);
+}
+
+void PathLibrary::Touch(CacheEntry& entry, const std::string& name)
+{
+	recentlyUsed.erase(entry.order);
+	recentlyUsed.push_front(name);
+	entry.order = recentlyUsed.begin();
+}
+
+void PathLibrary::Remove(const std::string& name)
+{
+	auto it = cache.find(name);
+	if (it == cache.end())
+		return;
+	cachedBytes -= it->second.bytes;
+	recentlyUsed.erase(it->second.order);
+	cache.erase(it);
+}
+
+void PathLibrary::Evict()
+{
+	while (cachedBytes > memoryCap && recentlyUsed.size() > 1)
+		Remove(recentlyUsed.back());
+}
+
+std::shared_ptr<PathTrack> PathLibrary::Get(const std::string& name)
+{
+	PathIndexEntry* entry = FindEntry(name);
+	if (!entry)
+		return nullptr;
+
+	auto cached = cache.find(name);
+	if (cached != cache.end())
+	{
+		CacheEntry& cacheEntry = cached->second;
+		Touch(cacheEntry, name);
+		if (!cacheEntry.hasStrategies)
+		{
+			cachedBytes -= cacheEntry.bytes;
+			cacheEntry.bytes = buildStrategies(*cacheEntry.track);
+			cacheEntry.bytes += EstimatePathBytes(*cacheEntry.track);
+			cacheEntry.hasStrategies = true;
+			cachedBytes += cacheEntry.bytes;
+			Evict();
+		}
+		return cacheEntry.track;
+	}
+
+	TRACE_SCOPE("PathLibrary::Load");
+	std::string contents;
+	if (!ReadContents(entry->file, contents))
+		return nullptr;
+	auto track = std::make_shared<PathTrack>();
+	track->name = name;
+	try
+	{
+		track->path = std::make_shared<savetype>(LoadPathFromString(contents));
+	}
+	catch (const std::exception&)
+	{
+		return nullptr;
+	}
+	if (track->path->size() < 2)
+		return nullptr;
+
+	//The file can change between scans, keep the index in line with what was loaded
+	uint64_t hash = HashContents(contents);
+	if (hash != entry->hash)
+	{
+		Summarize(*track->path, *entry);
+		entry->hash = hash;
+		entry->fileSize = contents.size();
+		revision++;
+	}
+
+	CacheEntry cacheEntry;
+	cacheEntry.track = track;
+	cacheEntry.hash = hash;
+	cacheEntry.bytes = buildStrategies(*track);
+	cacheEntry.bytes += EstimatePathBytes(*track);
+	cacheEntry.hasStrategies = true;
+	recentlyUsed.push_front(name);
+	cacheEntry.order = recentlyUsed.begin();
+	cache[name] = cacheEntry;
+	cachedBytes += cacheEntry.bytes;
+	Evict();
+	return track;
+}
+
+void PathLibrary::ResetStrategies()
+{
+	for (auto& item : cache)
+	{
+		//Tracks that were handed out keep working with their old strategies
+		CacheEntry& cacheEntry = item.second;
+		auto track = std::make_shared<PathTrack>();
+		track->name = cacheEntry.track->name;
+		track->path = cacheEntry.track->path;
+		cacheEntry.track = track;
+		cacheEntry.hasStrategies = false;
+		cachedBytes -= cacheEntry.bytes;
+		cacheEntry.bytes = EstimatePathBytes(*cacheEntry.track);
+		cachedBytes += cacheEntry.bytes;
+	}
+}
+
+void PathLibrary::SetMemoryCap(size_t bytes)
+{
+	memoryCap = bytes;
+	Evict();
+}
+
+size_t PathLibrary::GetMemoryCap() const
+{
+	return memoryCap;
+}
+
+size_t PathLibrary::GetCachedBytes() const
+{
+	return cachedBytes;
+}
+
+size_t PathLibrary::GetCachedCount() const
+{
+	return cache.size();
+}
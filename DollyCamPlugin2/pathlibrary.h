@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include "models.h"
+#include "pathtrack.h"
+
+//Summary of a saved path, kept for every file in the library so browsing doesn't need the path itself
+struct PathIndexEntry
+{
+	std::string file;
+	std::string name;
+	uint64_t hash = 0; //FNV-1a of the file contents
+	uintmax_t fileSize = 0;
+	long long writeTime = 0;
+	int startFrame = 0;
+	int endFrame = 0;
+	size_t keyframes = 0;
+	Vector boundsMin;
+	Vector boundsMax;
+};
+
+//Index of every path file in a directory. Paths are only decoded when they are used, decoded paths and their strategies
+//are kept in a least recently used cache that evicts the oldest paths once their estimated memory goes over the cap.
+class PathLibrary
+{
+public:
+	//Builds the strategies of a freshly decoded track and returns the estimated amount of bytes they use
+	typedef std::function<size_t(PathTrack&)> StrategyBuilder;
+
+private:
+	struct CacheEntry
+	{
+		std::shared_ptr<PathTrack> track;
+		uint64_t hash = 0;
+		size_t bytes = 0;
+		bool hasStrategies = false;
+		std::list<std::string>::iterator order;
+	};
+
+	StrategyBuilder buildStrategies;
+	std::string directory;
+	std::vector<PathIndexEntry> entries; //Sorted by name
+	unsigned int revision = 0;
+
+	std::unordered_map<std::string, CacheEntry> cache;
+	std::list<std::string> recentlyUsed; //Most recently used first
+	size_t memoryCap;
+	size_t cachedBytes = 0;
+
+	PathIndexEntry* FindEntry(const std::string& name);
+	void Touch(CacheEntry& entry, const std::string& name);
+	void Remove(const std::string& name);
+	//Evicts the least recently used paths until the cache fits, the most recent path is always kept
+	void Evict();
+
+public:
+	PathLibrary(StrategyBuilder buildStrategies, size_t memoryCap);
+	//Indexes every path file in the directory, files that didn't change since the last scan keep their entry. Returns the amount of paths
+	size_t Scan(const std::string& directory);
+	const std::string& GetDirectory() const;
+	const std::vector<PathIndexEntry>& GetEntries() const;
+	//Changes every time a scan changes the index
+	unsigned int GetRevision() const;
+	const PathIndexEntry* Find(const std::string& name) const;
+	//Returns the decoded path with its strategies, loading it if it isn't cached. Returns nullptr if the path can't be loaded
+	std::shared_ptr<PathTrack> Get(const std::string& name);
+	//Drops the strategies of every cached path, they are rebuilt the next time the path is used
+	void ResetStrategies();
+	void SetMemoryCap(size_t bytes);
+	size_t GetMemoryCap() const;
+	size_t GetCachedBytes() const;
+	size_t GetCachedCount() const;
+};
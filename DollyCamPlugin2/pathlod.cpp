@@ -0,0 +1,151 @@
+#include "pathlod.h"
+#include "pathrenderer.h"
+#include <algorithm>
+#include <cmath>
+
+#define MIN_LOD_DISTANCE 10.f //Same as the near plane, keeps nodes around the camera from dividing by zero
+
+static float Length(const Vector& v)
+{
+	return sqrt(Vector::dot(v, v));
+}
+
+static float DistanceToSegment(const Vector& point, const Vector& start, const Vector& end)
+{
+	Vector segment = end - start;
+	float lengthSquared = Vector::dot(segment, segment);
+	if (lengthSquared < .0001f)
+		return Length(point - start);
+	float t = (std::max)(0.f, (std::min)(1.f, Vector::dot(point - start, segment) / lengthSquared));
+	return Length(point - (start + segment * t));
+}
+
+int PathLOD::AddNode(const std::vector<Vector>& positions, size_t first, size_t last)
+{
+	Node node;
+	node.first = first;
+	node.last = last;
+	node.split = first + 1;
+	for (size_t i = first + 1; i < last; i++)
+	{
+		float distance = DistanceToSegment(positions[i], positions[first], positions[last]);
+		if (distance > node.error)
+		{
+			node.error = distance;
+			node.split = i;
+		}
+	}
+	//A straight run has no furthest point, split in the middle to keep the tree balanced
+	if (node.error <= 0.f)
+		node.split = first + (last - first) / 2;
+	nodes.push_back(node);
+	return (int)nodes.size() - 1;
+}
+
+void PathLOD::Build(const std::vector<Vector>& positions)
+{
+	nodes.clear();
+	pointCount = positions.size();
+	if (pointCount < 3)
+		return;
+
+	nodes.reserve(pointCount);
+	stack.clear();
+	stack.push_back(AddNode(positions, 0, pointCount - 1));
+	while (!stack.empty())
+	{
+		int index = stack.back();
+		stack.pop_back();
+		size_t first = nodes[index].first;
+		size_t split = nodes[index].split;
+		size_t last = nodes[index].last;
+		//Ranges of two points are just a line and don't need a node
+		if (split - first >= 2)
+		{
+			int left = AddNode(positions, first, split);
+			nodes[index].left = left;
+			stack.push_back(left);
+		}
+		if (last - split >= 2)
+		{
+			int right = AddNode(positions, split, last);
+			nodes[index].right = right;
+			stack.push_back(right);
+		}
+	}
+	ComputeBounds(positions);
+}
+
+void PathLOD::ComputeBounds(const std::vector<Vector>& positions)
+{
+	//Children are always created after their parent, so walking backwards visits them first
+	std::vector<Vector> boundsMin(nodes.size());
+	std::vector<Vector> boundsMax(nodes.size());
+	for (size_t n = nodes.size(); n-- > 0;)
+	{
+		Node& node = nodes[n];
+		Vector low = positions[node.first];
+		Vector high = low;
+		auto grow = [&](const Vector& otherLow, const Vector& otherHigh)
+		{
+			low = Vector((std::min)(low.X, otherLow.X), (std::min)(low.Y, otherLow.Y), (std::min)(low.Z, otherLow.Z));
+			high = Vector((std::max)(high.X, otherHigh.X), (std::max)(high.Y, otherHigh.Y), (std::max)(high.Z, otherHigh.Z));
+		};
+		grow(positions[node.split], positions[node.split]);
+		grow(positions[node.last], positions[node.last]);
+		if (node.left >= 0)
+		{
+			grow(boundsMin[node.left], boundsMax[node.left]);
+			node.error = (std::max)(node.error, nodes[node.left].error);
+		}
+		if (node.right >= 0)
+		{
+			grow(boundsMin[node.right], boundsMax[node.right]);
+			node.error = (std::max)(node.error, nodes[node.right].error);
+		}
+		boundsMin[n] = low;
+		boundsMax[n] = high;
+		node.center = (low + high) * .5f;
+		node.radius = Length(high - low) * .5f;
+	}
+}
+
+void PathLOD::Select(const ViewFrustum& frustum, float focalLength, float pixelError, std::vector<size_t>& selected)
+{
+	if (pointCount == 0)
+		return;
+	selected.push_back(0);
+	selected.push_back(pointCount - 1);
+	if (nodes.empty())
+	{
+		for (size_t i = 1; i + 1 < pointCount; i++)
+			selected.push_back(i);
+		return;
+	}
+
+	const Vector& cameraLocation = frustum.GetLocation();
+	stack.clear();
+	stack.push_back(0);
+	while (!stack.empty())
+	{
+		const Node& node = nodes[stack.back()];
+		stack.pop_back();
+		//Off screen ranges only keep their endpoints, which are enough for lines to reach the edge of the screen
+		if (!frustum.IsSphereVisible(node.center, node.radius))
+			continue;
+		float distance = (std::max)(Length(node.center - cameraLocation) - node.radius, MIN_LOD_DISTANCE);
+		if (node.error * focalLength / distance < pixelError)
+			continue;
+
+		selected.push_back(node.split);
+		if (node.left >= 0)
+			stack.push_back(node.left);
+		if (node.right >= 0)
+			stack.push_back(node.right);
+	}
+}
+
+size_t PathLOD::GetNodeCount() const
+{
+	return nodes.size();
+}
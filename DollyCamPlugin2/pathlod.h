@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include "models.h"
+
+class ViewFrustum;
+
+//Douglas-Peucker hierarchy over a polyline, built once per render path.
+//Every node splits its range at the point furthest from the chord, selecting a level of detail walks the tree
+//and stops descending once the node's error projects to less than the allowed amount of pixels.
+class PathLOD
+{
+private:
+	struct Node
+	{
+		size_t first;
+		size_t last;
+		size_t split;
+		int left = -1;
+		int right = -1;
+		float error = 0.f; //Largest deviation from the chord anywhere below this node
+		Vector center; //Bounding sphere of every point in the range
+		float radius = 0.f;
+	};
+
+	std::vector<Node> nodes;
+	std::vector<int> stack;
+	size_t pointCount = 0;
+
+	int AddNode(const std::vector<Vector>& positions, size_t first, size_t last);
+	void ComputeBounds(const std::vector<Vector>& positions);
+
+public:
+	void Build(const std::vector<Vector>& positions);
+	//Appends the indices of the points needed for the given pixel error to selected, unsorted
+	void Select(const ViewFrustum& frustum, float focalLength, float pixelError, std::vector<size_t>& selected);
+	size_t GetNodeCount() const;
+};
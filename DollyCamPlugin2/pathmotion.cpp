@@ -0,0 +1,133 @@
+#include "pathmotion.h"
+#include <cmath>
+#include <algorithm>
+
+#define MIN_TIME_STEP .0001f
+
+static float Length(const Vector& v)
+{
+	return sqrt(v.X * v.X + v.Y * v.Y + v.Z * v.Z);
+}
+
+void PathMotion::Clear()
+{
+	samples.clear();
+	frames.clear();
+	for (int channel = 0; channel < MOTION_CHANNEL_COUNT; channel++)
+	{
+		channels[channel].clear();
+		maxima[channel] = 0;
+	}
+}
+
+void PathMotion::AddSample(int frame, float time, const NewPOV& pov, const MotionDerivatives& derivatives)
+{
+	Sample sample;
+	sample.frame = frame;
+	sample.time = time;
+	sample.location = pov.location;
+	sample.derivatives = derivatives;
+	if (samples.empty())
+	{
+		sample.rotation = Vector(pov.rotation.Pitch._value, pov.rotation.Yaw._value, pov.rotation.Roll._value);
+	}
+	else
+	{
+		auto diffRotation = previousRotation.diffTo(pov.rotation);
+		sample.rotation = samples.back().rotation + Vector(diffRotation.Pitch._value, diffRotation.Yaw._value, diffRotation.Roll._value);
+	}
+	previousRotation = pov.rotation;
+	samples.push_back(sample);
+}
+
+void PathMotion::Finish()
+{
+	size_t count = samples.size();
+	frames.resize(count);
+	for (int channel = 0; channel < MOTION_CHANNEL_COUNT; channel++)
+	{
+		channels[channel].resize(count);
+		maxima[channel] = 0;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Sample& sample = samples[i];
+		Vector velocity, acceleration, angularVelocity;
+		if (sample.derivatives.valid)
+		{
+			velocity = sample.derivatives.velocity;
+			acceleration = sample.derivatives.acceleration;
+			angularVelocity = sample.derivatives.angularVelocity;
+		}
+		else if (count > 1)
+		{
+			//Differences on uneven time steps, one sided at the ends of the path
+			size_t previous = i > 0 ? i - 1 : i;
+			size_t next = i + 1 < count ? i + 1 : i;
+			float span = (std::max)(samples[next].time - samples[previous].time, MIN_TIME_STEP);
+			velocity = (samples[next].location - samples[previous].location) * (1.f / span);
+			angularVelocity = (samples[next].rotation - samples[previous].rotation) * (1.f / span);
+			if (i > 0 && i + 1 < count)
+			{
+				float before = (std::max)(sample.time - samples[i - 1].time, MIN_TIME_STEP);
+				float after = (std::max)(samples[i + 1].time - sample.time, MIN_TIME_STEP);
+				Vector slopeBefore = (sample.location - samples[i - 1].location) * (1.f / before);
+				Vector slopeAfter = (samples[i + 1].location - sample.location) * (1.f / after);
+				acceleration = (slopeAfter - slopeBefore) * (2.f / (before + after));
+			}
+		}
+
+		frames[i] = sample.frame;
+		channels[MOTION_SPEED][i] = Length(velocity);
+		channels[MOTION_ANGULAR_SPEED][i] = Length(angularVelocity) / ROTATOR_UNITS_PER_DEGREE;
+		channels[MOTION_ACCELERATION][i] = Length(acceleration);
+	}
+	//Ends without a centered difference take the acceleration of their neighbour
+	if (count > 2)
+	{
+		if (!samples.front().derivatives.valid)
+			channels[MOTION_ACCELERATION].front() = channels[MOTION_ACCELERATION][1];
+		if (!samples.back().derivatives.valid)
+			channels[MOTION_ACCELERATION].back() = channels[MOTION_ACCELERATION][count - 2];
+	}
+
+	for (int channel = 0; channel < MOTION_CHANNEL_COUNT; channel++)
+	{
+		for (float value : channels[channel])
+			maxima[channel] = (std::max)(maxima[channel], value);
+	}
+	samples.clear();
+	samples.shrink_to_fit();
+}
+
+size_t PathMotion::GetPointCount() const
+{
+	return frames.size();
+}
+
+const std::vector<int>& PathMotion::GetFrames() const
+{
+	return frames;
+}
+
+const std::vector<float>& PathMotion::GetChannel(MotionChannel channel) const
+{
+	return channels[channel];
+}
+
+float PathMotion::GetMax(MotionChannel channel) const
+{
+	return maxima[channel];
+}
+
+const char* PathMotion::GetChannelName(MotionChannel channel)
+{
+	switch (channel)
+	{
+	case MOTION_SPEED: return "Speed (uu/s)";
+	case MOTION_ANGULAR_SPEED: return "Angular speed (deg/s)";
+	case MOTION_ACCELERATION: return "Acceleration (uu/s^2)";
+	default: return "";
+	}
+}
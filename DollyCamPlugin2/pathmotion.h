@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include "models.h"
+
+enum MotionChannel
+{
+	MOTION_SPEED, //Unreal units per second
+	MOTION_ANGULAR_SPEED, //Degrees per second
+	MOTION_ACCELERATION, //Unreal units per second squared
+	MOTION_CHANNEL_COUNT
+};
+
+//Speed, angular speed and acceleration at every point of the render path, filled in while the render path is sampled.
+//Points the strategy gave analytic derivatives for use those, the rest are differentiated from their neighbouring samples
+class PathMotion
+{
+private:
+	struct Sample
+	{
+		int frame;
+		float time;
+		Vector location;
+		Vector rotation; //Unwrapped pitch, yaw, roll
+		MotionDerivatives derivatives;
+	};
+
+	std::vector<Sample> samples;
+	CustomRotator previousRotation;
+	std::vector<int> frames;
+	std::vector<float> channels[MOTION_CHANNEL_COUNT];
+	float maxima[MOTION_CHANNEL_COUNT] = {};
+
+public:
+	void Clear();
+	void AddSample(int frame, float time, const NewPOV& pov, const MotionDerivatives& derivatives);
+	//Computes the channels once every sample of the render path was added
+	void Finish();
+
+	size_t GetPointCount() const;
+	const std::vector<int>& GetFrames() const;
+	const std::vector<float>& GetChannel(MotionChannel channel) const;
+	float GetMax(MotionChannel channel) const;
+	static const char* GetChannelName(MotionChannel channel);
+};
@@ -0,0 +1,207 @@
+#include "pathoptimizer.h"
+#include "bandedsolver.h"
+#include "tracing.h"
+#include <cmath>
+#include <algorithm>
+
+#define CHANNELS 7
+#define BANDWIDTH 3 //The velocity and acceleration of a snapshot only couple with those of its neighbours
+#define MIN_SEGMENT_TIME .0001
+
+//Derivatives of the t^3, t^4 and t^5 coefficients of a quintic segment of length h to p0, v0, a0, p1, v1, a1
+static void QuinticGradients(double h, double c3[6], double c4[6], double c5[6])
+{
+	double h2 = h * h;
+	double g3[6] = { -20, -12 * h, -3 * h2, 20, -8 * h, h2 };
+	double g4[6] = { 30, 16 * h, 3 * h2, -30, 14 * h, -2 * h2 };
+	double g5[6] = { -12, -6 * h, -h2, 12, -6 * h, h2 };
+	for (int i = 0; i < 6; i++)
+	{
+		c3[i] = g3[i] / (2 * h2 * h);
+		c4[i] = g4[i] / (2 * h2 * h2);
+		c5[i] = g5[i] / (2 * h2 * h2 * h);
+	}
+}
+
+PathOptimizer::PathOptimizer(PathTolerance _tolerance, PlaybackStrategies _playback) : tolerance(_tolerance), playback(_playback)
+{
+}
+
+void PathOptimizer::InitKnots(const savetype& path, const std::vector<int>& stopFrames)
+{
+	knots.clear();
+	knots.reserve(path.size());
+	auto previousRotation = path.begin()->second.rotation;
+	double accumulatedPitch = previousRotation.Pitch._value;
+	double accumulatedYaw = previousRotation.Yaw._value;
+	double accumulatedRoll = previousRotation.Roll._value;
+	for (const auto& item : path)
+	{
+		const CameraSnapshot& snapshot = item.second;
+		auto diffRotation = previousRotation.diffTo(snapshot.rotation);
+		accumulatedPitch += diffRotation.Pitch._value;
+		accumulatedYaw += diffRotation.Yaw._value;
+		accumulatedRoll += diffRotation.Roll._value;
+		previousRotation = snapshot.rotation;
+
+		Knot knot;
+		knot.values[0] = snapshot.location.X;
+		knot.values[1] = snapshot.location.Y;
+		knot.values[2] = snapshot.location.Z;
+		knot.values[3] = accumulatedPitch;
+		knot.values[4] = accumulatedYaw;
+		knot.values[5] = accumulatedRoll;
+		knot.values[6] = snapshot.FOV;
+		knot.stop = std::find(stopFrames.begin(), stopFrames.end(), item.first) != stopFrames.end();
+		knot.snapshot = &snapshot;
+		knots.push_back(knot);
+	}
+}
+
+void PathOptimizer::Solve()
+{
+	TRACE_SCOPE("PathOptimizer::Solve");
+	//Unknowns are the velocity (2k) and acceleration (2k + 1) of every knot
+	size_t n = knots.size() * 2;
+	std::vector<double> band(n * (BANDWIDTH + 1), 0.0);
+	std::vector<double> rhs(n * CHANNELS, 0.0);
+
+	double c3[6], c4[6], c5[6];
+	const int freeParams[4] = { 1, 2, 4, 5 };
+	for (size_t k = 0; k + 1 < knots.size(); k++)
+	{
+		double h = (std::max)(knots[k + 1].time - knots[k].time, MIN_SEGMENT_TIME);
+		QuinticGradients(h, c3, c4, c5);
+
+		//Jerk is a + b*t + c*t^2, its squared integral over the segment is a quadratic form in the segment parameters
+		double Q[6][6];
+		for (int i = 0; i < 6; i++)
+		{
+			double ai = 6 * c3[i], bi = 24 * c4[i], ci = 60 * c5[i];
+			for (int j = 0; j < 6; j++)
+			{
+				double aj = 6 * c3[j], bj = 24 * c4[j], cj = 60 * c5[j];
+				Q[i][j] = h * ai * aj + h * h / 2 * (ai * bj + bi * aj) + h * h * h / 3 * (bi * bj + ai * cj + ci * aj)
+					+ h * h * h * h / 4 * (bi * cj + ci * bj) + h * h * h * h * h / 5 * ci * cj;
+			}
+		}
+
+		auto unknown = [&](int param) { return 2 * k + (param < 3 ? param - 1 : param - 2); };
+		for (int i : freeParams)
+		{
+			size_t row = unknown(i);
+			for (int j : freeParams)
+			{
+				size_t column = unknown(j);
+				if (column <= row)
+					band[row * (BANDWIDTH + 1) + (row - column)] += Q[i][j];
+			}
+			for (int c = 0; c < CHANNELS; c++)
+				rhs[row * CHANNELS + c] -= Q[i][0] * knots[k].values[c] + Q[i][3] * knots[k + 1].values[c];
+		}
+	}
+
+	//The ends start and stop without acceleration, stopped knots without velocity
+	std::vector<size_t> fixed = { 1, n - 1 };
+	for (size_t k = 0; k < knots.size(); k++)
+	{
+		if (knots[k].stop)
+			fixed.push_back(2 * k);
+	}
+	for (size_t u : fixed)
+	{
+		for (size_t d = 1; d <= BANDWIDTH && d <= u; d++)
+			band[u * (BANDWIDTH + 1) + d] = 0;
+		for (size_t i = u + 1; i < n && i <= u + BANDWIDTH; i++)
+			band[i * (BANDWIDTH + 1) + (i - u)] = 0;
+		band[u * (BANDWIDTH + 1)] = 1;
+		for (int c = 0; c < CHANNELS; c++)
+			rhs[u * CHANNELS + c] = 0;
+	}
+
+	SolveBanded(band, rhs, n, BANDWIDTH, CHANNELS);
+	for (size_t k = 0; k < knots.size(); k++)
+	{
+		for (int c = 0; c < CHANNELS; c++)
+		{
+			knots[k].velocity[c] = rhs[2 * k * CHANNELS + c];
+			knots[k].acceleration[c] = rhs[(2 * k + 1) * CHANNELS + c];
+		}
+	}
+}
+
+void PathOptimizer::Evaluate(size_t segment, double time, double* values) const
+{
+	const Knot& from = knots[segment];
+	const Knot& to = knots[segment + 1];
+	double h = (std::max)(to.time - from.time, MIN_SEGMENT_TIME);
+	double t = (std::max)(0.0, (std::min)(time - from.time, h));
+	double c3[6], c4[6], c5[6];
+	QuinticGradients(h, c3, c4, c5);
+	for (int c = 0; c < CHANNELS; c++)
+	{
+		double params[6] = { from.values[c], from.velocity[c], from.acceleration[c], to.values[c], to.velocity[c], to.acceleration[c] };
+		double a3 = 0, a4 = 0, a5 = 0;
+		for (int i = 0; i < 6; i++)
+		{
+			a3 += c3[i] * params[i];
+			a4 += c4[i] * params[i];
+			a5 += c5[i] * params[i];
+		}
+		values[c] = params[0] + t * (params[1] + t * (params[2] / 2 + t * (a3 + t * (a4 + t * a5))));
+	}
+}
+
+savetype PathOptimizer::Sample(const FrameTimeTable& frameTimes) const
+{
+	savetype dense;
+	int firstFrame = knots.front().snapshot->frame;
+	int lastFrame = knots.back().snapshot->frame;
+	size_t segment = 0;
+	double values[CHANNELS];
+	for (int frame = firstFrame; frame <= lastFrame; frame++)
+	{
+		double time = frameTimes.GetTime(frame);
+		while (segment + 2 < knots.size() && time > knots[segment + 1].time)
+			segment++;
+		Evaluate(segment, time, values);
+
+		CameraSnapshot snapshot;
+		snapshot.frame = frame;
+		snapshot.timeStamp = float(time);
+		snapshot.location = Vector(float(values[0]), float(values[1]), float(values[2]));
+		snapshot.rotation = CustomRotator(float(values[3]), float(values[4]), float(values[5]));
+		snapshot.FOV = float(values[6]);
+		snapshot.weight = knots[segment].snapshot->weight;
+		dense.insert_or_assign(frame, snapshot);
+	}
+	return dense;
+}
+
+savetype PathOptimizer::Optimize(const savetype& path, const FrameTimeTable& frameTimes, const std::vector<int>& stopFrames)
+{
+	withinTolerance = true;
+	if (path.size() < 3 || frameTimes.IsEmpty())
+		return path;
+
+	InitKnots(path, stopFrames);
+	//Snapshots are played at the time the frame table gives them, which skips outlier timestamps
+	for (auto& knot : knots)
+		knot.time = frameTimes.GetTime(knot.snapshot->frame);
+	Solve();
+	savetype dense = Sample(frameTimes);
+
+	//The ends and the stops stay keyframes with their exact values, the other snapshots are only kept where the curve needs them
+	std::vector<int> keepFrames = stopFrames;
+	keepFrames.push_back(path.begin()->first);
+	keepFrames.push_back((--path.end())->first);
+	PathReducer reducer(tolerance, playback);
+	savetype reduced = reducer.Reduce(dense, keepFrames);
+	withinTolerance = reducer.IsWithinTolerance();
+	return reduced;
+}
+
+bool PathOptimizer::IsWithinTolerance() const
+{
+	return withinTolerance;
+}
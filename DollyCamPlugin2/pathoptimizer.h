@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include "models.h"
+#include "pathtiming.h"
+#include "pathreducer.h"
+
+//Replaces a path with the minimum jerk curve through its snapshots.
+//Every segment is a quintic, the velocity and acceleration at every snapshot are found by minimizing the jerk
+//of the whole curve, which is a banded system that is solved in linear time. The curve keeps passing through every snapshot
+//at its frame, velocities can be pinned to zero at chosen snapshots. The curve is then reduced to as few snapshots as the tolerance allows,
+//keeping the path ends and the stopped snapshots.
+class PathOptimizer
+{
+private:
+	struct Knot
+	{
+		double time;
+		double values[7]; //x, y, z, unwrapped pitch, yaw, roll, FOV
+		double velocity[7];
+		double acceleration[7];
+		bool stop = false;
+		const CameraSnapshot* snapshot;
+	};
+
+	PathTolerance tolerance;
+	PlaybackStrategies playback;
+	std::vector<Knot> knots;
+	bool withinTolerance = false;
+
+	void InitKnots(const savetype& path, const std::vector<int>& stopFrames);
+	void Solve();
+	void Evaluate(size_t segment, double time, double* values) const;
+	savetype Sample(const FrameTimeTable& frameTimes) const;
+
+public:
+	PathOptimizer(PathTolerance tolerance, PlaybackStrategies playback);
+	//Returns the reduced curve, paths that are too short are returned as is
+	savetype Optimize(const savetype& path, const FrameTimeTable& frameTimes, const std::vector<int>& stopFrames);
+	//False if the last optimized path was still out of tolerance after reducing it
+	bool IsWithinTolerance() const;
+};
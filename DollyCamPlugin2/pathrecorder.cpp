@@ -0,0 +1,112 @@
+#include "pathrecorder.h"
+#include <cmath>
+
+PathRecorder::PathRecorder(size_t windowSize)
+{
+	window.resize(windowSize < 2 ? 2 : windowSize);
+}
+
+void PathRecorder::Start(PathTolerance _tolerance)
+{
+	tolerance = _tolerance;
+	windowStart = 0;
+	windowCount = 0;
+	hasAnchor = false;
+	lastFrame = -1;
+	samplesRecorded = 0;
+	keyframes.clear();
+}
+
+const CameraSnapshot& PathRecorder::WindowAt(size_t index) const
+{
+	return window[(windowStart + index) % window.size()];
+}
+
+void PathRecorder::PushWindow(const CameraSnapshot& sample)
+{
+	window[(windowStart + windowCount) % window.size()] = sample;
+	windowCount++;
+}
+
+void PathRecorder::Emit(const CameraSnapshot& sample)
+{
+	keyframes.insert_or_assign(sample.frame, sample);
+	anchor = sample;
+	hasAnchor = true;
+}
+
+bool PathRecorder::FitsSegment(const CameraSnapshot& start, const CameraSnapshot& end, const CameraSnapshot& sample) const
+{
+	float totalTime = end.timeStamp - start.timeStamp;
+	float t = totalTime > 0.f ? (sample.timeStamp - start.timeStamp) / totalTime : 0.f;
+	if (totalTime <= 0.f && end.frame != start.frame) //Timestamps can repeat when the replay is paused, fall back to frames
+		t = float(sample.frame - start.frame) / float(end.frame - start.frame);
+
+	Vector location = start.location + (end.location - start.location) * t;
+	if ((sample.location - location).magnitude() > tolerance.location)
+		return false;
+
+	CustomRotator rotation = start.rotation + start.rotation.diffTo(end.rotation) * t;
+	CustomRotator rotationError = rotation.diffTo(sample.rotation);
+	float maxRotationError = tolerance.rotation * ROTATOR_UNITS_PER_DEGREE;
+	if (fabs(rotationError.Pitch._value) > maxRotationError || fabs(rotationError.Yaw._value) > maxRotationError || fabs(rotationError.Roll._value) > maxRotationError)
+		return false;
+
+	float fov = start.FOV + (end.FOV - start.FOV) * t;
+	return fabs(sample.FOV - fov) <= tolerance.FOV;
+}
+
+bool PathRecorder::SegmentFitsWindow(const CameraSnapshot& end) const
+{
+	for (size_t i = 0; i < windowCount; i++)
+	{
+		if (!FitsSegment(anchor, end, WindowAt(i)))
+			return false;
+	}
+	return true;
+}
+
+void PathRecorder::AddSample(const CameraSnapshot& sample)
+{
+	if (sample.frame == lastFrame) //UpdatePOV can tick several times per replay frame
+		return;
+	lastFrame = sample.frame;
+	samplesRecorded++;
+
+	if (!hasAnchor)
+	{
+		Emit(sample);
+		return;
+	}
+
+	//The newest buffered sample was a valid segment end, so it becomes the next keyframe when the new one is not
+	if (windowCount > 0 && (windowCount == window.size() || !SegmentFitsWindow(sample)))
+	{
+		CameraSnapshot keyframe = WindowAt(windowCount - 1);
+		windowStart = 0;
+		windowCount = 0;
+		Emit(keyframe);
+	}
+	PushWindow(sample);
+}
+
+savetype PathRecorder::Finish()
+{
+	if (windowCount > 0)
+	{
+		Emit(WindowAt(windowCount - 1));
+		windowStart = 0;
+		windowCount = 0;
+	}
+	return keyframes;
+}
+
+int PathRecorder::GetSamplesRecorded() const
+{
+	return samplesRecorded;
+}
+
+size_t PathRecorder::GetKeyframeCount() const
+{
+	return keyframes.size() + (windowCount > 0 ? 1 : 0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include "models.h"
+
+//Records the camera every tick and reduces it to keyframes while recording.
+//Only the samples since the last emitted keyframe are kept (in a fixed size ring buffer),
+//a sample is emitted once the segment from the last keyframe no longer fits the buffered samples.
+class PathRecorder
+{
+private:
+	PathTolerance tolerance;
+	std::vector<CameraSnapshot> window; //Ring buffer with the samples since anchor
+	size_t windowStart = 0;
+	size_t windowCount = 0;
+	CameraSnapshot anchor;
+	bool hasAnchor = false;
+	int lastFrame = -1;
+	int samplesRecorded = 0;
+	savetype keyframes;
+
+	const CameraSnapshot& WindowAt(size_t index) const;
+	void PushWindow(const CameraSnapshot& sample);
+	void Emit(const CameraSnapshot& sample);
+	bool FitsSegment(const CameraSnapshot& start, const CameraSnapshot& end, const CameraSnapshot& sample) const;
+	bool SegmentFitsWindow(const CameraSnapshot& end) const;
+
+public:
+	PathRecorder(size_t windowSize = 256);
+	void Start(PathTolerance tolerance);
+	void AddSample(const CameraSnapshot& sample);
+	//Emits the last pending sample and returns the reduced path
+	savetype Finish();
+	int GetSamplesRecorded() const;
+	size_t GetKeyframeCount() const;
+};
@@ -0,0 +1,266 @@
+#include "pathreducer.h"
+#include "bandedsolver.h"
+#include "pathtiming.h"
+#include <cmath>
+#include <algorithm>
+
+#define CHANNELS 7
+#define BANDWIDTH 3 //Cubic basis functions overlap with 3 neighbours
+
+//Values of the 4 cubic basis functions that are non-zero at u, returns the index of the first one (The NURBS Book, A2.2)
+static size_t CubicBasis(const std::vector<tinyspline::real>& knots, double u, double basis[4])
+{
+	size_t numCtrlp = knots.size() - 4;
+	size_t span = std::upper_bound(knots.begin() + 4, knots.begin() + numCtrlp, u) - knots.begin() - 1;
+	double left[4], right[4];
+	basis[0] = 1.0;
+	for (int j = 1; j <= 3; j++)
+	{
+		left[j] = u - knots[span + 1 - j];
+		right[j] = knots[span + j] - u;
+		double saved = 0.0;
+		for (int r = 0; r < j; r++)
+		{
+			double denominator = right[r + 1] + left[j - r];
+			double temp = denominator > 0.0 ? basis[r] / denominator : 0.0;
+			basis[r] = saved + right[r + 1] * temp;
+			saved = left[j - r] * temp;
+		}
+		basis[j] = saved;
+	}
+	return span - 3;
+}
+
+//Entry (i, j) of a symmetric matrix stored as its lower band
+static double BandAt(const std::vector<double>& band, size_t i, size_t j)
+{
+	if (i < j)
+		std::swap(i, j);
+	return i - j <= BANDWIDTH ? band[i * (BANDWIDTH + 1) + (i - j)] : 0.0;
+}
+
+PathReducer::PathReducer(PathTolerance _tolerance, PlaybackStrategies _playback, int _maxIterations) : tolerance(_tolerance), playback(_playback), maxIterations(_maxIterations)
+{
+}
+
+void PathReducer::InitSamples(const savetype& path)
+{
+	samples.clear();
+	samples.reserve(path.size());
+
+	const CameraSnapshot& first = path.begin()->second;
+	const CameraSnapshot& last = (--path.end())->second;
+	bool useTime = last.timeStamp > first.timeStamp;
+	double start = useTime ? first.timeStamp : first.frame;
+	double length = useTime ? last.timeStamp - first.timeStamp : last.frame - first.frame;
+
+	auto previousRotation = first.rotation;
+	double accumulatedPitch = previousRotation.Pitch._value;
+	double accumulatedYaw = previousRotation.Yaw._value;
+	double accumulatedRoll = previousRotation.Roll._value;
+	for (const auto& item : path)
+	{
+		const CameraSnapshot& snapshot = item.second;
+		auto diffRotation = previousRotation.diffTo(snapshot.rotation);
+		accumulatedPitch += diffRotation.Pitch._value;
+		accumulatedYaw += diffRotation.Yaw._value;
+		accumulatedRoll += diffRotation.Roll._value;
+		previousRotation = snapshot.rotation;
+
+		Sample sample;
+		sample.u = ((useTime ? snapshot.timeStamp : snapshot.frame) - start) / length;
+		sample.u = (std::min)(1.0, (std::max)(0.0, sample.u));
+		sample.values[0] = snapshot.location.X;
+		sample.values[1] = snapshot.location.Y;
+		sample.values[2] = snapshot.location.Z;
+		sample.values[3] = accumulatedPitch;
+		sample.values[4] = accumulatedYaw;
+		sample.values[5] = accumulatedRoll;
+		sample.values[6] = snapshot.FOV;
+		sample.snapshot = &snapshot;
+		sample.pinned = false;
+		samples.push_back(sample);
+	}
+}
+
+tinyspline::BSpline PathReducer::Fit(const std::vector<size_t>& knotSamples)
+{
+	size_t numCtrlp = knotSamples.size() + 2;
+	std::vector<tinyspline::real> knots;
+	knots.insert(knots.end(), 4, 0.0);
+	for (size_t i = 1; i + 1 < knotSamples.size(); i++)
+		knots.push_back(samples[knotSamples[i]].u);
+	knots.insert(knots.end(), 4, 1.0);
+
+	//Only the band of the normal matrix is stored, every sample touches the 4 basis functions around it
+	std::vector<double> normal(numCtrlp * (BANDWIDTH + 1), 0.0);
+	std::vector<double> rhs(numCtrlp * CHANNELS, 0.0);
+	double basis[4];
+	for (const auto& sample : samples)
+	{
+		size_t first = CubicBasis(knots, sample.u, basis);
+		for (size_t i = 0; i < 4; i++)
+		{
+			size_t row = first + i;
+			for (size_t j = 0; j <= i; j++)
+				normal[row * (BANDWIDTH + 1) + (i - j)] += basis[i] * basis[j];
+			for (int c = 0; c < CHANNELS; c++)
+				rhs[row * CHANNELS + c] += basis[i] * sample.values[c];
+		}
+	}
+
+	//The path ends are kept exact, only the inner control points are fitted
+	const Sample& firstSample = samples.front();
+	const Sample& lastSample = samples.back();
+	size_t numInner = numCtrlp - 2;
+	size_t lastCtrlp = numCtrlp - 1;
+	std::vector<double> innerNormal(numInner * (BANDWIDTH + 1), 0.0);
+	std::vector<double> innerRhs(numInner * CHANNELS, 0.0);
+	for (size_t i = 0; i < numInner; i++)
+	{
+		for (size_t d = 0; d <= BANDWIDTH && d <= i; d++)
+			innerNormal[i * (BANDWIDTH + 1) + d] = normal[(i + 1) * (BANDWIDTH + 1) + d];
+		innerNormal[i * (BANDWIDTH + 1)] += 1e-9; //Keeps spans without samples solvable
+		double firstWeight = BandAt(normal, i + 1, 0);
+		double lastWeight = BandAt(normal, i + 1, lastCtrlp);
+		for (int c = 0; c < CHANNELS; c++)
+			innerRhs[i * CHANNELS + c] = rhs[(i + 1) * CHANNELS + c] - firstWeight * firstSample.values[c] - lastWeight * lastSample.values[c];
+	}
+	SolveBanded(innerNormal, innerRhs, numInner, BANDWIDTH, CHANNELS);
+
+	std::vector<tinyspline::real> ctrlp(firstSample.values, firstSample.values + CHANNELS);
+	ctrlp.insert(ctrlp.end(), innerRhs.begin(), innerRhs.end());
+	ctrlp.insert(ctrlp.end(), lastSample.values, lastSample.values + CHANNELS);
+
+	tinyspline::BSpline fitted(numCtrlp, CHANNELS, 3, TS_CLAMPED);
+	fitted.setControlPoints(ctrlp);
+	fitted.setKnots(knots);
+	return fitted;
+}
+
+double PathReducer::GetError(const Sample& sample, const NewPOV& played) const
+{
+	Vector offset = played.location - sample.snapshot->location;
+	double error = sqrt(offset.X * offset.X + offset.Y * offset.Y + offset.Z * offset.Z) / (std::max)(tolerance.location, .001f);
+	double maxRotationError = (std::max)(tolerance.rotation * ROTATOR_UNITS_PER_DEGREE, .001f);
+	auto diffRotation = sample.snapshot->rotation.diffTo(played.rotation);
+	error = (std::max)(error, fabs(diffRotation.Pitch._value) / maxRotationError);
+	error = (std::max)(error, fabs(diffRotation.Yaw._value) / maxRotationError);
+	error = (std::max)(error, fabs(diffRotation.Roll._value) / maxRotationError);
+	return (std::max)(error, fabs(played.FOV - sample.values[6]) / (std::max)(tolerance.FOV, .001f));
+}
+
+savetype PathReducer::BuildPath(const std::vector<size_t>& knotSamples, const tinyspline::BSpline& fitted) const
+{
+	savetype path;
+	for (size_t index : knotSamples)
+	{
+		auto value = fitted.eval(samples[index].u).result();
+		NewPOV fittedPov;
+		fittedPov.location = Vector(float(value[0]), float(value[1]), float(value[2]));
+		fittedPov.rotation = CustomRotator(float(value[3]), float(value[4]), float(value[5]));
+		fittedPov.FOV = float(value[6]);
+		//A keyframe the spline doesn't fit yet keeps the sample it replaces
+		CameraSnapshot snapshot = *samples[index].snapshot;
+		if (!samples[index].pinned && GetError(samples[index], fittedPov) <= 1.0)
+		{
+			snapshot.location = fittedPov.location;
+			snapshot.rotation = fittedPov.rotation;
+			snapshot.FOV = fittedPov.FOV;
+		}
+		path.insert_or_assign(snapshot.frame, snapshot);
+	}
+	return path;
+}
+
+std::vector<size_t> PathReducer::FindNewKnots(const std::vector<size_t>& knotSamples, const savetype& path, bool& outOfTolerance) const
+{
+	//The spline only places the keyframes, what is checked is what the strategies make of them
+	auto strategyPath = std::make_shared<savetype>(path);
+	auto locationStrategy = playback.location(strategyPath);
+	auto rotationStrategy = playback.rotation ? playback.rotation(strategyPath) : nullptr;
+	FrameTimeTable frameTimes;
+	frameTimes.Build(path, playback.replayTickRate);
+
+	outOfTolerance = false;
+	std::vector<size_t> newKnots;
+	for (size_t span = 0; span + 1 < knotSamples.size(); span++)
+	{
+		size_t worstSample = 0;
+		double worstError = 0.0;
+		for (size_t i = knotSamples[span]; i < knotSamples[span + 1]; i++)
+		{
+			int frame = samples[i].snapshot->frame;
+			float time = frameTimes.GetTime(frame);
+			NewPOV played = locationStrategy->GetPOV(time, frame);
+			if (rotationStrategy)
+			{
+				NewPOV rotationPov = rotationStrategy->GetPOV(time, frame);
+				played.rotation = rotationPov.rotation;
+				played.FOV = rotationPov.FOV;
+			}
+			//Frames the strategies can't evaluate aren't played at all, the span needs more keyframes
+			double error = played.FOV < 1 ? HUGE_VAL : GetError(samples[i], played);
+			if (error > 1.0 && error > worstError)
+			{
+				worstError = error;
+				worstSample = i;
+			}
+		}
+		if (worstError == 0.0)
+			continue;
+		outOfTolerance = true;
+		size_t spanStart = knotSamples[span];
+		size_t spanLength = knotSamples[span + 1] - spanStart;
+		if (spanLength < 2) //No sample left to put a knot on
+			continue;
+		//Knots right next to another knot make the least-squares fit swing, keep them in the middle half of the span
+		size_t minSample = spanStart + (std::max<size_t>)(1, spanLength / 4);
+		size_t maxSample = spanStart + (std::min)(spanLength - 1, spanLength - spanLength / 4);
+		newKnots.push_back((std::min)((std::max)(worstSample, minSample), maxSample));
+	}
+	return newKnots;
+}
+
+savetype PathReducer::Reduce(const savetype& path, const std::vector<int>& keepFrames)
+{
+	withinTolerance = true;
+	if (path.size() < 5)
+		return path;
+
+	InitSamples(path);
+	std::vector<size_t> knotSamples = { 0, samples.size() - 1 };
+	std::vector<int> sortedKeepFrames = keepFrames;
+	std::sort(sortedKeepFrames.begin(), sortedKeepFrames.end());
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		if (!std::binary_search(sortedKeepFrames.begin(), sortedKeepFrames.end(), samples[i].snapshot->frame))
+			continue;
+		samples[i].pinned = true;
+		if (i > 0 && i + 1 < samples.size())
+			knotSamples.push_back(i);
+	}
+	std::sort(knotSamples.begin(), knotSamples.end());
+	savetype reduced;
+	for (int iteration = 0; ; iteration++)
+	{
+		tinyspline::BSpline fitted = Fit(knotSamples);
+		reduced = BuildPath(knotSamples, fitted);
+		bool outOfTolerance;
+		std::vector<size_t> newKnots = FindNewKnots(knotSamples, reduced, outOfTolerance);
+		if (newKnots.empty() || iteration + 1 >= maxIterations)
+		{
+			withinTolerance = !outOfTolerance;
+			break;
+		}
+
+		knotSamples.insert(knotSamples.end(), newKnots.begin(), newKnots.end());
+		std::sort(knotSamples.begin(), knotSamples.end());
+	}
+	return reduced;
+}
+
+bool PathReducer::IsWithinTolerance() const
+{
+	return withinTolerance;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <functional>
+#include "models.h"
+#include "interpstrategies/interpstrategy.h"
+#include "interpstrategies/tinyspline/tinysplinecpp.h"
+
+typedef std::function<std::shared_ptr<InterpStrategy>(std::shared_ptr<savetype>)> StrategyFactory;
+
+//Builds the strategies playback uses for a path
+struct PlaybackStrategies
+{
+	StrategyFactory location;
+	StrategyFactory rotation; //Empty when the location strategy also gives the rotation and FOV
+	float replayTickRate = 1.f / 30.f;
+};
+
+//Fits a least-squares cubic B-spline to a dense path and writes the spline back as a small path.
+//Knots start at the path ends, the keyframes are placed on the knots. The keyframes are played back with the given strategies
+//and a knot is inserted at the worst sample of every knot span where playback is out of tolerance.
+class PathReducer
+{
+private:
+	PathTolerance tolerance;
+	PlaybackStrategies playback;
+	int maxIterations;
+	bool withinTolerance = false;
+
+	struct Sample
+	{
+		double u;
+		double values[7]; //x, y, z, unwrapped pitch, yaw, roll, FOV
+		const CameraSnapshot* snapshot;
+		bool pinned; //Always a keyframe, with the value of the sample
+	};
+
+	std::vector<Sample> samples;
+
+	void InitSamples(const savetype& path);
+	tinyspline::BSpline Fit(const std::vector<size_t>& knotSamples);
+	savetype BuildPath(const std::vector<size_t>& knotSamples, const tinyspline::BSpline& fitted) const;
+	//Worst sample of every knot span that is out of tolerance when the path is played back
+	std::vector<size_t> FindNewKnots(const std::vector<size_t>& knotSamples, const savetype& path, bool& outOfTolerance) const;
+	//Largest channel error relative to its tolerance, above 1 means the sample is out of tolerance
+	double GetError(const Sample& sample, const NewPOV& played) const;
+
+public:
+	PathReducer(PathTolerance tolerance, PlaybackStrategies playback, int maxIterations = 32);
+	//Returns the reduced path, paths that are too short to reduce are returned as is.
+	//The samples on keepFrames stay keyframes with their exact values
+	savetype Reduce(const savetype& path, const std::vector<int>& keepFrames = std::vector<int>());
+	//False if the last reduced path was still out of tolerance after maxIterations
+	bool IsWithinTolerance() const;
+};
@@ -0,0 +1,325 @@
+#include "pathrenderer.h"
+#include "utils/parser.h"
+#include <cmath>
+#include <algorithm>
+
+#define NEAR_PLANE 10.f
+#define FRUSTUM_MARGIN 1.1f //Slightly wider than the view so lines leaving the screen aren't cut short
+#define MAX_MERGED_POINTS 64
+#define MERGE_TOLERANCE 1.f //Pixels
+#define LABEL_CELL_WIDTH 48 //Roughly the width of a frame number
+#define LABEL_CELL_HEIGHT 16
+
+ViewFrustum::ViewFrustum(const CameraView& view) : location(view.location)
+{
+	double pitch = view.rotation.Pitch * UNREAL_TO_RADIANS;
+	double yaw = view.rotation.Yaw * UNREAL_TO_RADIANS;
+	double roll = view.rotation.Roll * UNREAL_TO_RADIANS;
+	float sp = sin(pitch), cp = cos(pitch);
+	float sy = sin(yaw), cy = cos(yaw);
+	float sr = sin(roll), cr = cos(roll);
+
+	//Same axes as Unreals rotation matrix
+	forward = Vector(cp * cy, cp * sy, sp);
+	right = Vector(sr * sp * cy - cr * sy, sr * sp * sy + cr * cy, -sr * cp);
+	up = Vector(-(cr * sp * cy + sr * sy), cy * sr - cr * sp * sy, cr * cp);
+
+	float aspect = view.canvasSize.X > 0 ? (float)view.canvasSize.Y / (float)view.canvasSize.X : 9.f / 16.f;
+	tanHorizontal = tan(view.FOV * .5 * M_PI / 180.0) * FRUSTUM_MARGIN;
+	tanVertical = tanHorizontal * aspect;
+}
+
+bool ViewFrustum::IsInFront(const Vector& point) const
+{
+	return Vector::dot(point - location, forward) > NEAR_PLANE;
+}
+
+bool ViewFrustum::IsVisible(const Vector& point) const
+{
+	Vector toPoint = point - location;
+	float depth = Vector::dot(toPoint, forward);
+	if (depth <= NEAR_PLANE)
+		return false;
+	return fabs(Vector::dot(toPoint, right)) <= depth * tanHorizontal && fabs(Vector::dot(toPoint, up)) <= depth * tanVertical;
+}
+
+bool ViewFrustum::IsSphereVisible(const Vector& center, float radius) const
+{
+	Vector toCenter = center - location;
+	float depth = Vector::dot(toCenter, forward);
+	if (depth + radius <= NEAR_PLANE)
+		return false;
+	//Distance from a side plane grows with the secant of its angle
+	return fabs(Vector::dot(toCenter, right)) <= depth * tanHorizontal + radius * sqrt(1 + tanHorizontal * tanHorizontal)
+		&& fabs(Vector::dot(toCenter, up)) <= depth * tanVertical + radius * sqrt(1 + tanVertical * tanVertical);
+}
+
+const Vector& ViewFrustum::GetLocation() const
+{
+	return location;
+}
+
+void PathRenderer::SetPath(const savetype& renderPath, const savetype& keyframes, const PathMotion& pathMotion)
+{
+	positions.clear();
+	frames.clear();
+	positions.reserve(renderPath.size());
+	frames.reserve(renderPath.size());
+	for (const auto& item : renderPath)
+	{
+		positions.push_back(item.second.location);
+		frames.push_back(item.first);
+	}
+	lod.Build(positions);
+
+	frameLabelText.clear();
+	frameLabelText.reserve(frames.size());
+	for (int frame : frames)
+		frameLabelText.push_back(to_string(frame));
+
+	keyframePositions.clear();
+	keyframeLabelText.clear();
+	int index = 1;
+	for (const auto& item : keyframes)
+	{
+		keyframePositions.push_back(item.second.location);
+		keyframeLabelText.push_back("(" + to_string(index) + ")" + " (ID:" + to_string(item.first) + ", w:" + to_string_with_precision(item.second.weight, 2) + ")");
+		index++;
+	}
+	motion = pathMotion;
+	UpdateOverlayValues();
+	pathRevision++;
+}
+
+void PathRenderer::SetMotionOverlay(int channel)
+{
+	if (channel == motionOverlay)
+		return;
+	motionOverlay = channel;
+	UpdateOverlayValues();
+	pathRevision++;
+}
+
+void PathRenderer::UpdateOverlayValues()
+{
+	overlayValues.clear();
+	if (motionOverlay < 0 || motionOverlay >= MOTION_CHANNEL_COUNT || motion.GetPointCount() != positions.size())
+		return;
+	MotionChannel channel = (MotionChannel)motionOverlay;
+	float max = motion.GetMax(channel);
+	float scale = max > 0 ? 1.f / max : 0.f;
+	for (float value : motion.GetChannel(channel))
+		overlayValues.push_back(value * scale);
+}
+
+PathRenderer::LineColor PathRenderer::GetLineColor(size_t firstPoint, size_t lastPoint) const
+{
+	if (overlayValues.empty())
+		return { 0, 0, 255 };
+	float value = 0;
+	for (size_t i = firstPoint; i <= lastPoint; i++)
+		value = (std::max)(value, overlayValues[i]);
+	//Green through yellow to red
+	unsigned char red = (unsigned char)(255 * (std::min)(1.f, value * 2));
+	unsigned char green = (unsigned char)(255 * (std::min)(1.f, (1 - value) * 2));
+	return { red, green, 0 };
+}
+
+size_t PathRenderer::GetPointCount() const
+{
+	return positions.size();
+}
+
+void PathRenderer::SetLODPixelError(float pixelError)
+{
+	lodPixelError = (std::max)(0.f, pixelError);
+}
+
+static bool IsCollinear(const std::vector<Vector2>& points, size_t start, size_t end)
+{
+	float dx = float(points[end].X - points[start].X);
+	float dy = float(points[end].Y - points[start].Y);
+	float length = sqrt(dx * dx + dy * dy);
+	for (size_t i = start + 1; i < end; i++)
+	{
+		float px = float(points[i].X - points[start].X);
+		float py = float(points[i].Y - points[start].Y);
+		float distance = length < .001f ? sqrt(px * px + py * py) : fabs(dx * py - dy * px) / length;
+		if (distance > MERGE_TOLERANCE)
+			return false;
+	}
+	return true;
+}
+
+static void DrawThickLine(CanvasWrapper& cw, Vector2 from, Vector2 to)
+{
+	cw.DrawLine(from, to);
+	cw.DrawLine(from.minus({ 1,1 }), to.minus({ 1,1 })); //make lines thicker
+	cw.DrawLine(from.minus({ -1,-1 }), to.minus({ -1,-1 }));
+}
+
+static Vector2 ClampToCanvas(Vector2 point, const Vector2& canvasSize)
+{
+	point.X = (std::max)(0, (std::min)(point.X, canvasSize.X));
+	point.Y = (std::max)(0, (std::min)(point.Y, canvasSize.Y));
+	return point;
+}
+
+void PathRenderer::AddRun(size_t first, size_t last)
+{
+	size_t lineStart = first;
+	for (size_t i = first + 1; i <= last; i++)
+	{
+		if (i < last && i + 1 - lineStart <= MAX_MERGED_POINTS && IsCollinear(projected, lineStart, i + 1))
+			continue;
+		lines.push_back({ projected[lineStart], projected[i], GetLineColor(selected[lineStart], selected[i]) });
+		lineStart = i;
+	}
+}
+
+bool PathRenderer::ClaimLabelCell(const Vector2& position)
+{
+	if (position.X < 0 || position.Y < 0)
+		return false;
+	size_t cell = (size_t)(position.Y / LABEL_CELL_HEIGHT) * labelGridColumns + position.X / LABEL_CELL_WIDTH;
+	if (cell >= labelGrid.size() || labelGrid[cell])
+		return false;
+	labelGrid[cell] = 1;
+	return true;
+}
+
+bool PathRenderer::IsCacheValid(const CameraView& view) const
+{
+	return cachedRevision == pathRevision && cachedPixelError == lodPixelError
+		&& cachedView.location.X == view.location.X && cachedView.location.Y == view.location.Y && cachedView.location.Z == view.location.Z
+		&& cachedView.rotation.Pitch == view.rotation.Pitch && cachedView.rotation.Yaw == view.rotation.Yaw && cachedView.rotation.Roll == view.rotation.Roll
+		&& cachedView.FOV == view.FOV && cachedView.canvasSize.X == view.canvasSize.X && cachedView.canvasSize.Y == view.canvasSize.Y;
+}
+
+void PathRenderer::RebuildDrawList(CanvasWrapper& cw, const CameraView& view)
+{
+	cachedView = view;
+	cachedRevision = pathRevision;
+	cachedPixelError = lodPixelError;
+	lines.clear();
+	frameLabels.clear();
+	keyframeLabels.clear();
+
+	ViewFrustum frustum(view);
+	labelGridColumns = (std::max)(view.canvasSize.X, 0) / LABEL_CELL_WIDTH + 1;
+	labelGrid.assign(labelGridColumns * ((std::max)(view.canvasSize.Y, 0) / LABEL_CELL_HEIGHT + 1), 0);
+
+	//Keyframe labels go first so frame numbers never hide them
+	for (size_t i = 0; i < keyframePositions.size(); i++)
+	{
+		if (!frustum.IsInFront(keyframePositions[i]))
+			continue;
+		Vector2 boxLoc = cw.Project(keyframePositions[i]);
+		if (boxLoc.X >= 0 && boxLoc.X <= view.canvasSize.X && boxLoc.Y >= 0 && boxLoc.Y <= view.canvasSize.Y)
+		{
+			boxLoc.X -= 5;
+			boxLoc.Y -= 5;
+			ClaimLabelCell(boxLoc);
+			keyframeLabels.push_back({ boxLoc, i });
+		}
+	}
+
+	selected.clear();
+	if (lodPixelError > 0 && view.canvasSize.X > 0)
+	{
+		float focalLength = view.canvasSize.X * .5f / tan(view.FOV * .5 * M_PI / 180.0);
+		lod.Select(frustum, focalLength, lodPixelError, selected);
+		std::sort(selected.begin(), selected.end());
+		selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+	}
+	else
+	{
+		for (size_t i = 0; i < positions.size(); i++)
+			selected.push_back(i);
+	}
+
+	size_t count = selected.size();
+	visible.resize(count);
+	for (size_t k = 0; k < count; k++)
+		visible[k] = frustum.IsVisible(positions[selected[k]]);
+
+	projected.resize(count);
+	const size_t noRun = count;
+	size_t runStart = noRun;
+	for (size_t k = 0; k < count; k++)
+	{
+		size_t i = selected[k];
+		//Points just outside the view are still drawn so lines reach the edge of the screen
+		bool draw = visible[k] || (((k > 0 && visible[k - 1]) || (k + 1 < count && visible[k + 1])) && frustum.IsInFront(positions[i]));
+		if (!draw)
+		{
+			if (runStart != noRun && k - 1 > runStart)
+				AddRun(runStart, k - 1);
+			runStart = noRun;
+			continue;
+		}
+
+		projected[k] = ClampToCanvas(cw.Project(positions[i]), view.canvasSize);
+		if (runStart == noRun)
+			runStart = k;
+		if (visible[k] && i > 0 && ClaimLabelCell(projected[k]))
+			frameLabels.push_back({ projected[k], i });
+	}
+	if (runStart != noRun && count - 1 > runStart)
+		AddRun(runStart, count - 1);
+}
+
+void PathRenderer::DrawHighlight(CanvasWrapper& cw, const CameraView& view, int currentFrame)
+{
+	//Segments take the color of the point they end in, so this is projected every frame instead of being cached
+	ViewFrustum frustum(view);
+	size_t end = std::lower_bound(frames.begin(), frames.end(), currentFrame - 1) - frames.begin();
+	cw.SetColor(255, 0, 0, 255);
+	for (; end < frames.size() && frames[end] < currentFrame + 2; end++)
+	{
+		if (end == 0)
+			continue;
+		const Vector& from = positions[end - 1];
+		const Vector& to = positions[end];
+		if (!frustum.IsInFront(from) || !frustum.IsInFront(to) || !(frustum.IsVisible(from) || frustum.IsVisible(to)))
+			continue;
+		DrawThickLine(cw, ClampToCanvas(cw.Project(from), view.canvasSize), ClampToCanvas(cw.Project(to), view.canvasSize));
+	}
+}
+
+void PathRenderer::Render(CanvasWrapper& cw, const CameraView& view, int currentFrame, bool renderFrames)
+{
+	if (positions.size() < 2)
+		return;
+
+	if (!IsCacheValid(view))
+		RebuildDrawList(cw, view);
+
+	for (const auto& line : lines)
+	{
+		cw.SetColor(line.color.r, line.color.g, line.color.b, 255);
+		DrawThickLine(cw, line.from, line.to);
+	}
+	DrawHighlight(cw, view, currentFrame);
+
+	if (renderFrames)
+	{
+		cw.SetColor(0, 0, 0, 255);
+		for (const auto& label : frameLabels)
+		{
+			cw.SetPosition(label.position);
+			cw.DrawString(frameLabelText[label.index]);
+		}
+	}
+
+	Vector2 boxSize;
+	boxSize.X = 10; boxSize.Y = 10;
+	for (const auto& label : keyframeLabels)
+	{
+		cw.SetColor(255, 0, 0, 255);
+		cw.SetPosition(label.position);
+		cw.FillBox(boxSize);
+		cw.SetColor(255, 255, 255, 255);
+		cw.DrawString(keyframeLabelText[label.index]);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "models.h"
+#include "pathlod.h"
+#include "pathmotion.h"
+#include "bakkesmod\wrappers\canvaswrapper.h"
+
+//Camera state the overlay is rendered from
+struct CameraView
+{
+	Vector location;
+	Rotator rotation;
+	float FOV = 90.f;
+	Vector2 canvasSize;
+};
+
+class ViewFrustum
+{
+private:
+	Vector location;
+	Vector forward;
+	Vector right;
+	Vector up;
+	float tanHorizontal;
+	float tanVertical;
+
+public:
+	ViewFrustum(const CameraView& view);
+	bool IsInFront(const Vector& point) const;
+	bool IsVisible(const Vector& point) const;
+	bool IsSphereVisible(const Vector& center, float radius) const;
+	const Vector& GetLocation() const;
+};
+
+//Draws the render path as thick lines, only projecting the points that can end up on screen
+//and merging consecutive segments that are collinear on screen into a single line.
+//Points are picked from a level of detail hierarchy so far away parts of the path use fewer segments.
+//The projected lines and labels are cached until the camera, canvas or path changes.
+//With a motion overlay every line is colored by the highest value of the chosen channel along it, from green to red
+class PathRenderer
+{
+private:
+	struct LineColor
+	{
+		unsigned char r;
+		unsigned char g;
+		unsigned char b;
+	};
+
+	struct ScreenLine
+	{
+		Vector2 from;
+		Vector2 to;
+		LineColor color;
+	};
+
+	struct ScreenLabel
+	{
+		Vector2 position;
+		size_t index;
+	};
+
+	std::vector<Vector> positions;
+	std::vector<int> frames;
+	PathLOD lod;
+	float lodPixelError = 1.f;
+
+	//Channel values of every point scaled to 0-1, empty without an overlay
+	PathMotion motion;
+	int motionOverlay = -1;
+	std::vector<float> overlayValues;
+
+	//Snapshots of the edited path, drawn as boxes
+	std::vector<Vector> keyframePositions;
+
+	//Label text is built once per path so drawing doesn't format strings
+	std::vector<std::string> frameLabelText;
+	std::vector<std::string> keyframeLabelText;
+
+	//Draw list and the state it was projected with
+	unsigned int pathRevision = 0;
+	unsigned int cachedRevision = 0;
+	float cachedPixelError = -1.f;
+	CameraView cachedView;
+	std::vector<ScreenLine> lines;
+	std::vector<ScreenLabel> frameLabels;
+	std::vector<ScreenLabel> keyframeLabels;
+
+	//Scratch buffers reused when rebuilding the draw list
+	std::vector<size_t> selected;
+	std::vector<unsigned char> visible;
+	std::vector<Vector2> projected;
+	std::vector<unsigned char> labelGrid;
+	int labelGridColumns = 0;
+
+	bool IsCacheValid(const CameraView& view) const;
+	void RebuildDrawList(CanvasWrapper& cw, const CameraView& view);
+	void AddRun(size_t first, size_t last);
+	void UpdateOverlayValues();
+	LineColor GetLineColor(size_t firstPoint, size_t lastPoint) const;
+	//Returns false if another label already occupies this part of the screen
+	bool ClaimLabelCell(const Vector2& position);
+	void DrawHighlight(CanvasWrapper& cw, const CameraView& view, int currentFrame);
+
+public:
+	void SetPath(const savetype& renderPath, const savetype& keyframes, const PathMotion& pathMotion);
+	size_t GetPointCount() const;
+	//MotionChannel to color the path by, anything else draws it in a single color
+	void SetMotionOverlay(int channel);
+	//Allowed screen space deviation in pixels, 0 draws every point
+	void SetLODPixelError(float pixelError);
+	void Render(CanvasWrapper& cw, const CameraView& view, int currentFrame, bool renderFrames);
+};
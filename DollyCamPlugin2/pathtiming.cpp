@@ -0,0 +1,229 @@
+#include "pathtiming.h"
+#include <cmath>
+#include <algorithm>
+
+//Fritsch-Carlson slopes keep the interpolation monotone between knots, flat or turning knots get a zero slope
+static std::vector<float> MonotoneSlopes(const std::vector<float>& x, const std::vector<float>& y)
+{
+	size_t count = x.size();
+	std::vector<float> secants(count - 1);
+	for (size_t k = 0; k + 1 < count; k++)
+		secants[k] = (y[k + 1] - y[k]) / (x[k + 1] - x[k]);
+	std::vector<float> slopes(count);
+	slopes[0] = secants[0];
+	slopes[count - 1] = secants[count - 2];
+	for (size_t k = 1; k + 1 < count; k++)
+	{
+		if (secants[k - 1] * secants[k] <= 0)
+		{
+			slopes[k] = 0;
+			continue;
+		}
+		float h0 = x[k] - x[k - 1];
+		float h1 = x[k + 1] - x[k];
+		float w0 = 2 * h1 + h0;
+		float w1 = h1 + 2 * h0;
+		slopes[k] = (w0 + w1) / (w0 / secants[k - 1] + w1 / secants[k]);
+	}
+	return slopes;
+}
+
+static float HermiteSegment(const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& slopes, size_t k, float value)
+{
+	float h = x[k + 1] - x[k];
+	float t = (value - x[k]) / h;
+	float t2 = t * t, t3 = t2 * t;
+	return (2 * t3 - 3 * t2 + 1) * y[k] + (t3 - 2 * t2 + t) * h * slopes[k]
+		+ (-2 * t3 + 3 * t2) * y[k + 1] + (t3 - t2) * h * slopes[k + 1];
+}
+
+void FrameTimeTable::Build(const savetype& path, float replayTickRate)
+{
+	times.clear();
+	if (path.empty())
+		return;
+	startFrame = path.begin()->first;
+	int endFrame = (--path.end())->first;
+
+	std::vector<float> knotFrames;
+	std::vector<float> knotTimes;
+	for (const auto& item : path)
+	{
+		if (!knotTimes.empty() && item.second.timeStamp <= knotTimes.back())
+			continue;
+		knotFrames.push_back((float)item.first);
+		knotTimes.push_back(item.second.timeStamp);
+	}
+
+	times.reserve(endFrame - startFrame + 1);
+	size_t knotCount = knotFrames.size();
+	if (knotCount < 2)
+	{
+		for (int i = startFrame; i <= endFrame; i++)
+			times.push_back(knotTimes[0] + replayTickRate * (i - startFrame));
+		return;
+	}
+
+	std::vector<float> slopes = MonotoneSlopes(knotFrames, knotTimes);
+
+	//Skipped outliers at the end leave frames after the last knot, those keep stepping at the last slope
+	size_t k = 0;
+	for (int i = startFrame; i <= endFrame; i++)
+	{
+		float frame = (float)i;
+		while (k + 2 < knotCount && frame > knotFrames[k + 1])
+			k++;
+		if (frame > knotFrames[k + 1])
+		{
+			times.push_back(knotTimes[k + 1] + slopes[k + 1] * (frame - knotFrames[k + 1]));
+			continue;
+		}
+		times.push_back(HermiteSegment(knotFrames, knotTimes, slopes, k, frame));
+	}
+}
+
+bool FrameTimeTable::IsEmpty() const
+{
+	return times.empty();
+}
+
+int FrameTimeTable::GetStartFrame() const
+{
+	return startFrame;
+}
+
+int FrameTimeTable::GetEndFrame() const
+{
+	return startFrame + (int)times.size() - 1;
+}
+
+float FrameTimeTable::GetTime(int frame) const
+{
+	if (times.empty())
+		return 0;
+	if (frame <= startFrame)
+		return times.front();
+	if (frame >= GetEndFrame())
+		return times.back();
+	return times[frame - startFrame];
+}
+
+float FrameTimeTable::GetTime(float frame) const
+{
+	int whole = (int)floor(frame);
+	float fraction = frame - whole;
+	float time = GetTime(whole);
+	if (fraction <= 0)
+		return time;
+	return time + (GetTime(whole + 1) - time) * fraction;
+}
+
+const std::vector<float>& FrameTimeTable::GetTimes() const
+{
+	return times;
+}
+
+std::vector<float> BuildFrameTimes(const savetype& path, float replayTickRate)
+{
+	FrameTimeTable table;
+	table.Build(path, replayTickRate);
+	return table.GetTimes();
+}
+
+bool TimeRemap::SetKey(int frame, float pathFrame)
+{
+	auto next = keys.upper_bound(frame);
+	if (next != keys.end() && next->second < pathFrame)
+		return false;
+	auto previous = keys.lower_bound(frame);
+	if (previous != keys.begin() && (--previous)->second > pathFrame)
+		return false;
+	keys[frame] = pathFrame;
+	Build();
+	return true;
+}
+
+bool TimeRemap::RemoveKey(int frame)
+{
+	if (keys.erase(frame) == 0)
+		return false;
+	Build();
+	return true;
+}
+
+void TimeRemap::Clear()
+{
+	keys.clear();
+	Build();
+}
+
+bool TimeRemap::IsEmpty() const
+{
+	return keys.empty();
+}
+
+const std::map<int, float>& TimeRemap::GetKeys() const
+{
+	return keys;
+}
+
+void TimeRemap::Build()
+{
+	keyFrames.clear();
+	keyValues.clear();
+	slopes.clear();
+	for (const auto& key : keys)
+	{
+		keyFrames.push_back((float)key.first);
+		keyValues.push_back(key.second);
+	}
+	if (keyFrames.size() >= 2)
+		slopes = MonotoneSlopes(keyFrames, keyValues);
+}
+
+float TimeRemap::Map(float frame) const
+{
+	if (keyFrames.empty())
+		return frame;
+	if (frame <= keyFrames.front())
+		return keyValues.front() + frame - keyFrames.front();
+	if (frame >= keyFrames.back())
+		return keyValues.back() + frame - keyFrames.back();
+	size_t k = std::upper_bound(keyFrames.begin(), keyFrames.end(), frame) - keyFrames.begin() - 1;
+	return HermiteSegment(keyFrames, keyValues, slopes, k, frame);
+}
+
+bool TimeRemap::FindFrameRange(float firstPathFrame, float lastPathFrame, int& firstFrame, int& lastFrame) const
+{
+	//Map keeps a slope of 1 outside the keys, so these bounds map below and above the range
+	float low = firstPathFrame, high = lastPathFrame;
+	if (!keyFrames.empty())
+	{
+		low = (std::min)(keyFrames.front(), firstPathFrame - keyValues.front() + keyFrames.front());
+		high = (std::max)(keyFrames.back(), lastPathFrame - keyValues.back() + keyFrames.back());
+	}
+	int below = (int)floor(low) - 1, above = (int)ceil(high) + 1;
+
+	//Map never decreases, search for the first frame at or past the start and the last one at or before the end
+	int lo = below, hi = above;
+	while (hi - lo > 1)
+	{
+		int middle = lo + (hi - lo) / 2;
+		if (Map((float)middle) >= firstPathFrame)
+			hi = middle;
+		else
+			lo = middle;
+	}
+	firstFrame = hi;
+	lo = below, hi = above;
+	while (hi - lo > 1)
+	{
+		int middle = lo + (hi - lo) / 2;
+		if (Map((float)middle) <= lastPathFrame)
+			lo = middle;
+		else
+			hi = middle;
+	}
+	lastFrame = lo;
+	return firstFrame <= lastFrame;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <map>
+#include "models.h"
+
+//Replay time of every frame between the first and last snapshot of a path.
+//Snapshot timestamps are joined with a monotone cubic so time never runs backwards and doesn't jump at snapshots,
+//snapshots whose timestamp is out of order with the previous one are treated as outliers and skipped
+class FrameTimeTable
+{
+private:
+	int startFrame = 0;
+	std::vector<float> times;
+
+public:
+	void Build(const savetype& path, float replayTickRate);
+	bool IsEmpty() const;
+	int GetStartFrame() const;
+	int GetEndFrame() const;
+	//Frames outside the table are clamped to its ends
+	float GetTime(int frame) const;
+	//Fractional frames are interpolated linearly between the two frames around it
+	float GetTime(float frame) const;
+	const std::vector<float>& GetTimes() const;
+};
+
+//Time of every frame between the first and last snapshot, see FrameTimeTable
+std::vector<float> BuildFrameTimes(const savetype& path, float replayTickRate);
+
+//Maps playback frames to path frames, so speed ramps and holds don't need the snapshots to be moved.
+//Keys are joined with a monotone cubic, before the first and after the last key the path plays at normal speed
+class TimeRemap
+{
+private:
+	std::map<int, float> keys;
+	std::vector<float> keyFrames;
+	std::vector<float> keyValues;
+	std::vector<float> slopes;
+	void Build();
+
+public:
+	//Returns false if the key would make the path run backwards
+	bool SetKey(int frame, float pathFrame);
+	bool RemoveKey(int frame);
+	void Clear();
+	bool IsEmpty() const;
+	const std::map<int, float>& GetKeys() const;
+	//Without keys every frame maps to itself
+	float Map(float frame) const;
+	//First and last replay frames that map into [firstPathFrame, lastPathFrame], returns false if no frame does
+	bool FindFrameRange(float firstPathFrame, float lastPathFrame, int& firstFrame, int& lastFrame) const;
+};
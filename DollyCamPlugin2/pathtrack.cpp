@@ -0,0 +1,28 @@
+#include "pathtrack.h"
+
+int PathTrack::GetStartFrame() const
+{
+	return path->begin()->first;
+}
+
+int PathTrack::GetEndFrame() const
+{
+	return (--path->end())->first;
+}
+
+bool PathTrack::Contains(int frame) const
+{
+	return !path->empty() && frame >= GetStartFrame() && frame <= GetEndFrame();
+}
+
+NewPOV PathTrack::Evaluate(float time, int frame) const
+{
+	NewPOV pov = locationStrategy->GetPOV(time, frame);
+	if (rotationStrategy != locationStrategy)
+	{
+		NewPOV secondaryPov = rotationStrategy->GetPOV(time, frame);
+		pov.rotation = secondaryPov.rotation;
+		pov.FOV = secondaryPov.FOV;
+	}
+	return pov;
+}
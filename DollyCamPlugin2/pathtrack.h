@@ -0,0 +1,22 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "models.h"
+#include "pathtiming.h"
+#include "interpstrategies/interpstrategy.h"
+
+//A named path kept in memory together with its strategies and frame times,
+//so playback can switch to it without rebuilding anything or touching the disk
+struct PathTrack
+{
+	std::string name;
+	std::shared_ptr<savetype> path;
+	std::shared_ptr<InterpStrategy> locationStrategy;
+	std::shared_ptr<InterpStrategy> rotationStrategy;
+	FrameTimeTable frameTimes;
+
+	int GetStartFrame() const;
+	int GetEndFrame() const;
+	bool Contains(int frame) const;
+	NewPOV Evaluate(float time, int frame) const;
+};
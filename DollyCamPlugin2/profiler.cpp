@@ -0,0 +1,211 @@
+#include "profiler.h"
+#include <cstdlib>
+#include <new>
+
+LatencyHistogram::LatencyHistogram()
+{
+	Reset();
+}
+
+int LatencyHistogram::GetBucket(uint64_t nanoseconds)
+{
+	if (nanoseconds < HISTOGRAM_LINEAR_BUCKETS)
+		return (int)nanoseconds;
+	int octave = 0;
+	for (uint64_t v = nanoseconds; v > 1; v >>= 1)
+		octave++;
+	//The bits below the highest set bit pick the sub bucket
+	int sub = (int)(nanoseconds >> (octave - HISTOGRAM_SUB_BUCKET_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1);
+	int bucket = HISTOGRAM_LINEAR_BUCKETS + (octave - 4) * HISTOGRAM_SUB_BUCKETS + sub;
+	return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(int bucket)
+{
+	if (bucket < HISTOGRAM_LINEAR_BUCKETS)
+		return (uint64_t)bucket + 1;
+	int octave = (bucket - HISTOGRAM_LINEAR_BUCKETS) / HISTOGRAM_SUB_BUCKETS + 4;
+	int sub = (bucket - HISTOGRAM_LINEAR_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+	return ((uint64_t)(HISTOGRAM_SUB_BUCKETS + sub + 1)) << (octave - HISTOGRAM_SUB_BUCKET_BITS);
+}
+
+void LatencyHistogram::Record(uint64_t nanoseconds)
+{
+	buckets[GetBucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+	total.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+	uint64_t current = minimum.load(std::memory_order_relaxed);
+	while (nanoseconds < current && !minimum.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed));
+	current = maximum.load(std::memory_order_relaxed);
+	while (nanoseconds > current && !maximum.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Reset()
+{
+	for (auto& bucket : buckets)
+		bucket.store(0, std::memory_order_relaxed);
+	count.store(0, std::memory_order_relaxed);
+	total.store(0, std::memory_order_relaxed);
+	minimum.store(UINT64_MAX, std::memory_order_relaxed);
+	maximum.store(0, std::memory_order_relaxed);
+}
+
+LatencyStats LatencyHistogram::GetStats() const
+{
+	LatencyStats stats;
+	stats.count = count.load(std::memory_order_relaxed);
+	if (stats.count == 0)
+		return stats;
+	stats.minUs = minimum.load(std::memory_order_relaxed) / 1000.0;
+	stats.maxUs = maximum.load(std::memory_order_relaxed) / 1000.0;
+	stats.meanUs = total.load(std::memory_order_relaxed) / 1000.0 / stats.count;
+
+	//Upper bound of the bucket holding the 99th percentile, capped by the largest value seen
+	uint64_t target = stats.count - stats.count / 100;
+	uint64_t seen = 0;
+	for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		seen += buckets[i].load(std::memory_order_relaxed);
+		if (seen >= target)
+		{
+			stats.p99Us = GetBucketUpperBound(i) / 1000.0;
+			break;
+		}
+	}
+	if (stats.p99Us > stats.maxUs)
+		stats.p99Us = stats.maxUs;
+	return stats;
+}
+
+void LatencyHistogram::GetBucketCounts(std::vector<float>& counts) const
+{
+	counts.clear();
+	int first = -1, last = -1;
+	for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		if (buckets[i].load(std::memory_order_relaxed) == 0)
+			continue;
+		if (first < 0)
+			first = i;
+		last = i;
+	}
+	if (first < 0)
+		return;
+	for (int i = first; i <= last; i++)
+		counts.push_back((float)buckets[i].load(std::memory_order_relaxed));
+}
+
+static LatencyHistogram stageHistograms[PROFILE_STAGE_COUNT];
+static std::atomic<uint64_t> stageAllocations[PROFILE_STAGE_COUNT];
+static std::atomic<uint64_t> stageAllocatedBytes[PROFILE_STAGE_COUNT];
+//Bit per stage that is currently running on this thread
+static thread_local unsigned int activeStages = 0;
+
+#ifdef DOLLY_COUNT_ALLOCATIONS
+static void CountAllocation(size_t size)
+{
+	for (unsigned int stages = activeStages, stage = 0; stages != 0; stages >>= 1, stage++)
+	{
+		if (stages & 1)
+		{
+			stageAllocations[stage].fetch_add(1, std::memory_order_relaxed);
+			stageAllocatedBytes[stage].fetch_add(size, std::memory_order_relaxed);
+		}
+	}
+}
+
+void* operator new(size_t size)
+{
+	CountAllocation(size);
+	void* p = malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	free(p);
+}
+#endif
+
+const char* GetProfileStageName(ProfileStage stage)
+{
+	switch (stage)
+	{
+	case PROFILE_APPLY: return "Apply";
+	case PROFILE_GETPOV: return "GetPOV";
+	case PROFILE_STRATEGY_REBUILD: return "Strategy rebuild";
+	case PROFILE_UPDATE_RENDER_PATH: return "UpdateRenderPath";
+	case PROFILE_RENDER: return "Render";
+	default: return "Unknown";
+	}
+}
+
+LatencyHistogram& GetStageHistogram(ProfileStage stage)
+{
+	return stageHistograms[stage];
+}
+
+void ResetStageHistograms()
+{
+	for (auto& histogram : stageHistograms)
+		histogram.Reset();
+	for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++)
+	{
+		stageAllocations[stage].store(0, std::memory_order_relaxed);
+		stageAllocatedBytes[stage].store(0, std::memory_order_relaxed);
+	}
+}
+
+bool IsAllocationCountingEnabled()
+{
+#ifdef DOLLY_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+AllocationStats GetStageAllocations(ProfileStage stage)
+{
+	AllocationStats stats;
+	stats.allocations = stageAllocations[stage].load(std::memory_order_relaxed);
+	stats.bytes = stageAllocatedBytes[stage].load(std::memory_order_relaxed);
+	return stats;
+}
+
+ScopedTimer::ScopedTimer(ProfileStage _stage) : stage(_stage), wasActive((activeStages & (1u << _stage)) != 0)
+{
+	activeStages |= 1u << stage;
+	start = std::chrono::steady_clock::now();
+}
+
+ScopedTimer::~ScopedTimer()
+{
+	if (!wasActive)
+		activeStages &= ~(1u << stage);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	stageHistograms[stage].Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+//Counts heap allocations made while a stage is running by replacing the global operator new of the plugin.
+//Off by default since every allocation of the plugin pays for it, build with msbuild /p:DollyCountAllocations=true
+//to define DOLLY_COUNT_ALLOCATIONS
+
+enum ProfileStage
+{
+	PROFILE_APPLY,
+	PROFILE_GETPOV,
+	PROFILE_STRATEGY_REBUILD,
+	PROFILE_UPDATE_RENDER_PATH,
+	PROFILE_RENDER,
+	PROFILE_STAGE_COUNT
+};
+
+#define HISTOGRAM_LINEAR_BUCKETS 16
+#define HISTOGRAM_SUB_BUCKET_BITS 3
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS) //Per power of two
+#define HISTOGRAM_BUCKETS (HISTOGRAM_LINEAR_BUCKETS + 40 * HISTOGRAM_SUB_BUCKETS)
+
+struct LatencyStats
+{
+	uint64_t count = 0;
+	double minUs = 0;
+	double meanUs = 0;
+	double p99Us = 0;
+	double maxUs = 0;
+};
+
+struct AllocationStats
+{
+	uint64_t allocations = 0;
+	uint64_t bytes = 0;
+};
+
+//Log-linear histogram of durations in nanoseconds, safe to record into from any thread without locking
+class LatencyHistogram
+{
+private:
+	std::atomic<uint64_t> buckets[HISTOGRAM_BUCKETS];
+	std::atomic<uint64_t> count;
+	std::atomic<uint64_t> total;
+	std::atomic<uint64_t> minimum;
+	std::atomic<uint64_t> maximum;
+
+	static int GetBucket(uint64_t nanoseconds);
+	static uint64_t GetBucketUpperBound(int bucket);
+
+public:
+	LatencyHistogram();
+	void Record(uint64_t nanoseconds);
+	void Reset();
+	LatencyStats GetStats() const;
+	//Bucket counts from the first to the last non empty bucket, for plotting
+	void GetBucketCounts(std::vector<float>& counts) const;
+};
+
+const char* GetProfileStageName(ProfileStage stage);
+LatencyHistogram& GetStageHistogram(ProfileStage stage);
+void ResetStageHistograms();
+bool IsAllocationCountingEnabled();
+//Allocations of nested stages are counted for the outer stage too
+AllocationStats GetStageAllocations(ProfileStage stage);
+
+//Records the lifetime of the object into the histogram of the given stage
+class ScopedTimer
+{
+private:
+	ProfileStage stage;
+	bool wasActive;
+	std::chrono::steady_clock::time_point start;
+
+public:
+	ScopedTimer(ProfileStage stage);
+	~ScopedTimer();
+};
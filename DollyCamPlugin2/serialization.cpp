@@ -1,6 +1,7 @@
 #include "serialization.h"
 #include "utils\parser.h"
 #include "bakkesmod\wrappers\wrapperstructs.h"
+#include <fstream>
 
 std::string vector_to_string(Vector v)
 {
@@ -45,7 +46,8 @@ void from_json(const json& j, CustomRotator& p) {
 
 void to_json(json& j, const CameraSnapshot& p) {
 	j = json{ { "frame", p.frame },{ "timestamp", p.timeStamp },{ "FOV", p.FOV },
-	{ "location", p.location },{ "rotation", p.rotation },{ "weight", p.weight } };
+	{ "location", p.location },{ "rotation", p.rotation },{ "weight", p.weight },
+	{ "tension", p.tension },{ "continuity", p.continuity },{ "bias", p.bias } };
 }
 
 void from_json(const json& j, CameraSnapshot& p) {
@@ -55,4 +57,49 @@ void from_json(const json& j, CameraSnapshot& p) {
 	p.location = j.at("location").get<Vector>();
 	p.rotation = (j.at("rotation").get<CustomRotator>());
 	p.weight = j.at("weight").get<float>();
+	//Paths saved before these existed use the defaults
+	p.tension = j.value("tension", 0.f);
+	p.continuity = j.value("continuity", 0.f);
+	p.bias = j.value("bias", 0.f);
 }
+
+void SavePathToFile(std::string filename, const savetype& path)
+{
+	std::map<string, CameraSnapshot> pathCopy;
+	for (auto& i : path)
+	{
+		pathCopy.insert_or_assign(to_string(i.first), i.second);
+	}
+	json j = pathCopy;
+	ofstream myfile;
+	myfile.open(filename);
+	myfile << j.dump(4);
+	myfile.close();
+}
+
+static savetype PathFromJson(const json& j)
+{
+	savetype path;
+	auto v8 = j.get<std::map<string, CameraSnapshot>>();
+	for (auto& i : v8)
+	{
+		string first = i.first;
+		int intVal = get_safe_int(first);
+		CameraSnapshot value = i.second;
+		path.insert_or_assign(intVal, value);
+	}
+	return path;
+}
+
+savetype LoadPathFromFile(std::string filename)
+{
+	std::ifstream i(filename);
+	json j;
+	i >> j;
+	return PathFromJson(j);
+}
+
+savetype LoadPathFromString(const std::string& contents)
+{
+	return PathFromJson(json::parse(contents));
+}
\ No newline at end of file
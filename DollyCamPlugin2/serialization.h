@@ -23,4 +23,12 @@ void from_json(const json& j, CustomRotator& p);
 
 void to_json(json& j, const CameraSnapshot& p);
 
-void from_json(const json& j, CameraSnapshot& p);
\ No newline at end of file
+void from_json(const json& j, CameraSnapshot& p);
+
+//Path files map the frame (as string) to the snapshot
+void SavePathToFile(std::string filename, const savetype& path);
+
+savetype LoadPathFromFile(std::string filename);
+
+//Same as LoadPathFromFile for a path file that is already read into memory
+savetype LoadPathFromString(const std::string& contents);
\ No newline at end of file
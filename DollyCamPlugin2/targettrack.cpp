@@ -0,0 +1,142 @@
+#include "targettrack.h"
+#include <fstream>
+#include <cstdint>
+#include <cmath>
+
+#define TARGET_TRACK_MAGIC 0x54544344 //"DCTT"
+#define TARGET_TRACK_VERSION 1
+
+struct TargetTrackHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	int32_t startFrame;
+	uint32_t frameCount;
+};
+
+void TargetTrack::Clear()
+{
+	positions.clear();
+}
+
+void TargetTrack::RecordFrame(int frame, const Vector& position)
+{
+	if (positions.empty())
+	{
+		startFrame = frame;
+		positions.push_back(position);
+		return;
+	}
+	if (frame < startFrame)
+	{
+		//Scrubbed back past the start, the frames in between are filled with the first known position
+		positions.insert(positions.begin(), startFrame - frame, positions.front());
+		startFrame = frame;
+	}
+	if (frame <= GetEndFrame())
+	{
+		positions[frame - startFrame] = position;
+		return;
+	}
+
+	Vector last = positions.back();
+	int gap = frame - GetEndFrame();
+	for (int i = 1; i <= gap; i++)
+		positions.push_back(last + (position - last) * (i / (float)gap));
+}
+
+bool TargetTrack::IsEmpty() const
+{
+	return positions.empty();
+}
+
+int TargetTrack::GetStartFrame() const
+{
+	return startFrame;
+}
+
+int TargetTrack::GetEndFrame() const
+{
+	return startFrame + (int)positions.size() - 1;
+}
+
+size_t TargetTrack::GetFrameCount() const
+{
+	return positions.size();
+}
+
+bool TargetTrack::GetTarget(float frame, Vector& target) const
+{
+	if (positions.empty() || frame < startFrame || frame > GetEndFrame())
+		return false;
+	int whole = (int)floor(frame);
+	size_t index = whole - startFrame;
+	float fraction = frame - whole;
+	target = positions[index];
+	if (fraction > 0 && index + 1 < positions.size())
+		target = target + (positions[index + 1] - target) * fraction;
+	return true;
+}
+
+bool TargetTrack::SaveToFile(std::string filename) const
+{
+	std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	TargetTrackHeader header = { TARGET_TRACK_MAGIC, TARGET_TRACK_VERSION, startFrame, (uint32_t)positions.size() };
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	std::vector<float> data;
+	data.reserve(positions.size() * 3);
+	for (const auto& position : positions)
+	{
+		data.push_back(position.X);
+		data.push_back(position.Y);
+		data.push_back(position.Z);
+	}
+	file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(float));
+	return file.good();
+}
+
+bool TargetTrack::LoadFromFile(std::string filename)
+{
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	TargetTrackHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != TARGET_TRACK_MAGIC || header.version != TARGET_TRACK_VERSION)
+		return false;
+
+	//The frame count comes from the file, check the file holds that many frames before allocating for them
+	std::streamoff dataStart = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff dataSize = file.tellg() - dataStart;
+	file.seekg(dataStart);
+	if ((uint64_t)header.frameCount * 3 * sizeof(float) != (uint64_t)dataSize)
+		return false;
+
+	std::vector<float> data((size_t)header.frameCount * 3);
+	if (!file.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float)))
+		return false;
+
+	startFrame = header.startFrame;
+	positions.clear();
+	positions.reserve(header.frameCount);
+	for (size_t i = 0; i < data.size(); i += 3)
+		positions.push_back(Vector(data[i], data[i + 1], data[i + 2]));
+	return true;
+}
+
+CustomRotator LookAtRotation(const Vector& location, const Vector& target, const CustomRotator& rotation)
+{
+	Vector direction = target - location;
+	double horizontal = sqrt(direction.X * direction.X + direction.Y * direction.Y);
+	if (horizontal < .001 && fabs(direction.Z) < .001)
+		return rotation;
+	float pitch = float(atan2(direction.Z, horizontal) * RADIANS_TO_UNREAL);
+	float yaw = float(atan2(direction.Y, direction.X) * RADIANS_TO_UNREAL);
+	//Stay on the winding of the path rotation so the yaw doesn't jump a full turn
+	return rotation + rotation.diffTo(CustomRotator(pitch, yaw, rotation.Roll._value));
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "models.h"
+
+//Position the camera looks at for every replay frame, recorded once from the replay or loaded from a file.
+//With look-at enabled the rotation comes from this track, so paths following the ball don't need dense snapshots
+class TargetTrack
+{
+private:
+	int startFrame = 0;
+	std::vector<Vector> positions;
+
+public:
+	void Clear();
+	//Frames skipped since the last recorded frame are filled in linearly, recording a frame again overwrites it
+	void RecordFrame(int frame, const Vector& position);
+	bool IsEmpty() const;
+	int GetStartFrame() const;
+	int GetEndFrame() const;
+	size_t GetFrameCount() const;
+	//Interpolates between the frames around it, returns false outside the track
+	bool GetTarget(float frame, Vector& target) const;
+
+	//Compact binary format: header followed by 3 floats (location) per frame
+	bool SaveToFile(std::string filename) const;
+	bool LoadFromFile(std::string filename);
+};
+
+//Rotation pointing a camera at location towards target, roll is kept from the given rotation
+CustomRotator LookAtRotation(const Vector& location, const Vector& target, const CustomRotator& rotation);
@@ -0,0 +1,100 @@
+#include "tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <functional>
+#include <thread>
+
+//Fields are written while WriteTrace may be reading the slot, sequence is the write index + 1 once the event is complete
+//and 0 while it is being written, a reader only keeps the event if the sequence is the one it expects before and after copying it
+struct TraceEvent
+{
+	std::atomic<uint64_t> sequence;
+	std::atomic<const char*> name;
+	std::atomic<int64_t> startNs;
+	std::atomic<int64_t> durationNs;
+	std::atomic<uint32_t> threadId;
+};
+
+static TraceEvent traceBuffer[TRACE_BUFFER_SIZE];
+static std::atomic<uint64_t> traceWriteIndex(0);
+//Indices only grow so a slot can't be mistaken for an event from before the trace was cleared
+static std::atomic<uint64_t> traceClearIndex(0);
+static std::atomic<bool> tracingEnabled(false);
+static const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+void SetTracingEnabled(bool enabled)
+{
+	tracingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsTracingEnabled()
+{
+	return tracingEnabled.load(std::memory_order_relaxed);
+}
+
+void ClearTrace()
+{
+	traceClearIndex.store(traceWriteIndex.load());
+}
+
+int WriteTrace(std::string filename)
+{
+	std::ofstream file(filename, std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+		return -1;
+
+	uint64_t end = traceWriteIndex.load();
+	uint64_t begin = (std::max)(end > TRACE_BUFFER_SIZE ? end - TRACE_BUFFER_SIZE : 0, traceClearIndex.load());
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	int written = 0;
+	for (uint64_t i = begin; i < end; i++)
+	{
+		TraceEvent& slot = traceBuffer[i % TRACE_BUFFER_SIZE];
+		//Skips events that are still being written or were overwritten by newer ones while dumping
+		uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence != i + 1)
+			continue;
+		const char* name = slot.name.load(std::memory_order_relaxed);
+		int64_t startNs = slot.startNs.load(std::memory_order_relaxed);
+		int64_t durationNs = slot.durationNs.load(std::memory_order_relaxed);
+		uint32_t threadId = slot.threadId.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+			continue;
+
+		if (written > 0)
+			file << ",";
+		//Timestamps are in microseconds
+		file << "\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId
+			<< ",\"ts\":" << startNs / 1000.0 << ",\"dur\":" << durationNs / 1000.0 << "}";
+		written++;
+	}
+	file << "\n]}\n";
+	return file.good() ? written : -1;
+}
+
+TraceScope::TraceScope(const char* _name) : name(_name), active(IsTracingEnabled())
+{
+	if (active)
+		start = std::chrono::steady_clock::now();
+}
+
+TraceScope::~TraceScope()
+{
+	if (!active)
+		return;
+	auto now = std::chrono::steady_clock::now();
+	uint64_t index = traceWriteIndex.fetch_add(1, std::memory_order_relaxed);
+	TraceEvent& event = traceBuffer[index % TRACE_BUFFER_SIZE];
+	event.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	event.name.store(name, std::memory_order_relaxed);
+	event.startNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(start - traceEpoch).count(), std::memory_order_relaxed);
+	event.durationNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count(), std::memory_order_relaxed);
+	event.threadId.store((uint32_t)std::hash<std::thread::id>()(std::this_thread::get_id()), std::memory_order_relaxed);
+	event.sequence.store(index + 1, std::memory_order_release);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+//Scoped events for chrome://tracing (or ui.perfetto.dev), recorded into a fixed size ring buffer while tracing is enabled.
+//Once the buffer is full the oldest events are overwritten
+#define TRACE_BUFFER_SIZE 65536
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+//Name has to be a string literal, only the pointer is stored
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+void SetTracingEnabled(bool enabled);
+bool IsTracingEnabled();
+void ClearTrace();
+//Writes the buffered events as Chrome trace JSON, returns the amount of events written or -1 if the file couldn't be opened
+int WriteTrace(std::string filename);
+
+class TraceScope
+{
+private:
+	const char* name;
+	bool active;
+	std::chrono::steady_clock::time_point start;
+
+public:
+	TraceScope(const char* name);
+	~TraceScope();
+};